@@ -0,0 +1,2859 @@
+// Sol2 analysis-index bindings for binja-lua
+//
+// Owns the per-BinaryView ViewIndex registry declared in
+// bindings/analysis_index.h, the BinaryDataNotification that keeps
+// the indexes current, and the index builders + Lua projections for
+// the whole-binary queries bound on the BinaryView usertype.
+
+#include "analysis_index.h"
+
+#include "il.h"
+#include "lowlevelilinstruction.h"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <regex>
+
+namespace BinjaLua {
+
+namespace {
+
+// Invalidation hooks. Every callback runs on a core analysis thread;
+// they only record what changed and leave the rebuild to the next
+// query. The notification holds a raw ViewIndex pointer: the registry
+// unregisters it before releasing the index on view finalization.
+class ViewIndexNotification : public BinaryDataNotification {
+public:
+    explicit ViewIndexNotification(ViewIndex* index) : m_index(index) {}
+
+    void OnAnalysisFunctionAdded(BinaryView*, Function* func) override {
+        m_index->MarkFunctionChanged(func->GetObject(), false);
+    }
+
+    void OnAnalysisFunctionRemoved(BinaryView*, Function* func) override {
+        m_index->MarkFunctionChanged(func->GetObject(), true);
+    }
+
+    void OnAnalysisFunctionUpdated(BinaryView*, Function* func) override {
+        m_index->MarkFunctionChanged(func->GetObject(), false);
+    }
+
+    void OnStringFound(BinaryView*, BNStringType, uint64_t, size_t) override {
+        m_index->MarkStringsChanged();
+    }
+
+    void OnStringRemoved(BinaryView*, BNStringType, uint64_t,
+                         size_t) override {
+        m_index->MarkStringsChanged();
+    }
+
+    void OnDataVariableAdded(BinaryView*, const DataVariable&) override {
+        m_index->MarkDataVariablesChanged();
+    }
+
+    void OnDataVariableRemoved(BinaryView*, const DataVariable&) override {
+        m_index->MarkDataVariablesChanged();
+    }
+
+    void OnDataVariableUpdated(BinaryView*, const DataVariable&) override {
+        m_index->MarkDataVariablesChanged();
+    }
+
+    void OnSectionAdded(BinaryView*, Section*) override {
+        m_index->MarkSectionsChanged();
+    }
+
+    void OnSectionRemoved(BinaryView*, Section*) override {
+        m_index->MarkSectionsChanged();
+    }
+
+    void OnSectionUpdated(BinaryView*, Section*) override {
+        m_index->MarkSectionsChanged();
+    }
+
+    void OnTagAdded(BinaryView*, const TagReference&) override {
+        m_index->MarkTagsChanged();
+    }
+
+    void OnTagRemoved(BinaryView*, const TagReference&) override {
+        m_index->MarkTagsChanged();
+    }
+
+    void OnTagUpdated(BinaryView*, const TagReference&) override {
+        m_index->MarkTagsChanged();
+    }
+
+    void OnSymbolAdded(BinaryView*, Symbol* sym) override {
+        m_index->MarkSymbolAdded(sym);
+    }
+
+    void OnSymbolUpdated(BinaryView*, Symbol*) override {
+        m_index->MarkSymbolsChanged();
+    }
+
+    void OnSymbolRemoved(BinaryView*, Symbol* sym) override {
+        m_index->MarkSymbolRemoved(sym);
+    }
+
+private:
+    ViewIndex* m_index;
+};
+
+struct RegistryEntry {
+    std::shared_ptr<ViewIndex> index;
+    std::unique_ptr<ViewIndexNotification> notification;
+};
+
+std::mutex s_registryMutex;
+std::map<BNBinaryView*, RegistryEntry> s_registry;
+std::once_flag s_finalizationHook;
+
+void DropViewIndex(BinaryView* view) {
+    if (!view) return;
+    RegistryEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        auto it = s_registry.find(view->GetObject());
+        if (it == s_registry.end()) return;
+        entry = std::move(it->second);
+        s_registry.erase(it);
+    }
+    view->UnregisterNotification(entry.notification.get());
+    // entry.index may outlive this call if a query still holds it;
+    // the notification is gone, so nothing writes to it any more.
+}
+
+// Truncate an immediate to its expression width. LLIL sizes are in
+// bytes; 0 and >= 8 leave the value untouched.
+uint64_t TruncateToSize(uint64_t value, size_t size) {
+    if (size == 0 || size >= 8) return value;
+    return value & ((1ULL << (size * 8)) - 1);
+}
+
+std::vector<ConstantUse> ScanFunctionConstants(const Ref<Function>& func) {
+    std::vector<ConstantUse> out;
+    Ref<LowLevelILFunction> il = func->GetLowLevelIL();
+    if (!il) return out;
+    const size_t count = il->GetInstructionCount();
+    for (size_t i = 0; i < count; ++i) {
+        LowLevelILInstruction instr = il->GetInstruction(i);
+        instr.VisitExprs([&](const LowLevelILInstruction& expr) -> bool {
+            switch (expr.operation) {
+                case LLIL_CONST:
+                case LLIL_CONST_PTR:
+                case LLIL_EXTERN_PTR:
+                    out.push_back({TruncateToSize(
+                                       expr.GetRawOperandAsInteger(0),
+                                       expr.size),
+                                   expr.address, 0});
+                    break;
+                default:
+                    break;
+            }
+            return true;
+        });
+    }
+    // The same immediate can appear in several expressions lifted from
+    // one instruction (e.g. a flag computation); report it once.
+    std::sort(out.begin(), out.end(),
+              [](const ConstantUse& a, const ConstantUse& b) {
+                  return a.value != b.value ? a.value < b.value
+                                            : a.address < b.address;
+              });
+    out.erase(std::unique(out.begin(), out.end(),
+                          [](const ConstantUse& a, const ConstantUse& b) {
+                              return a.value == b.value &&
+                                     a.address == b.address;
+                          }),
+              out.end());
+    return out;
+}
+
+void RefreshConstantIndex(ViewIndex& index, BinaryView& bv) {
+    ConstantIndex& ci = index.constants;
+    if (!ci.slices.Refresh(index, bv, ScanFunctionConstants)) return;
+
+    ci.merged.clear();
+    for (size_t f = 0; f < ci.slices.functions.size(); ++f) {
+        const auto* slice =
+            ci.slices.Find(ci.slices.functions[f]->GetObject());
+        if (!slice) continue;
+        for (ConstantUse use : *slice) {
+            use.func = static_cast<uint32_t>(f);
+            ci.merged.push_back(use);
+        }
+    }
+    std::sort(ci.merged.begin(), ci.merged.end(),
+              [](const ConstantUse& a, const ConstantUse& b) {
+                  return a.value != b.value ? a.value < b.value
+                                            : a.address < b.address;
+              });
+}
+
+sol::table ConstantUsesToTable(sol::state_view lua, const ConstantIndex& ci,
+                               std::vector<ConstantUse>::const_iterator first,
+                               std::vector<ConstantUse>::const_iterator last,
+                               bool with_value) {
+    sol::table result =
+        lua.create_table(static_cast<int>(std::distance(first, last)), 0);
+    int idx = 1;
+    for (auto it = first; it != last; ++it) {
+        sol::table entry = lua.create_table(0, with_value ? 3 : 2);
+        if (with_value) {
+            entry["value"] = static_cast<lua_Integer>(it->value);
+        }
+        entry["address"] = HexAddress(it->address);
+        entry["func"] = ci.slices.functions[it->func];
+        result[idx++] = entry;
+    }
+    return result;
+}
+
+// String references depend on both the string list and on code
+// analysis, so the index is rebuilt whole whenever either generation
+// moves. Per-string reference lookups are independent core queries and
+// fan out over the worker pool.
+void RefreshStringIndex(ViewIndex& index, BinaryView& bv) {
+    StringIndex& si = index.strings;
+    const uint64_t funcGen = index.FunctionsGeneration();
+    const uint64_t strGen = index.StringsGeneration();
+    if (funcGen == si.functionsGeneration &&
+        strGen == si.stringsGeneration) {
+        return;
+    }
+
+    std::vector<BNStringReference> found = bv.GetStrings();
+    std::vector<IndexedString> strings(found.size());
+    std::vector<std::vector<ReferenceSource>> sources(found.size());
+    ParallelFor(found.size(), [&](size_t i) {
+        const BNStringReference& ref = found[i];
+        IndexedString& s = strings[i];
+        s.start = ref.start;
+        s.length = ref.length;
+        s.type = ref.type;
+        if (ref.length > 0) {
+            DataBuffer data = bv.ReadBuffer(ref.start, ref.length);
+            s.value.assign(static_cast<const char*>(data.GetData()),
+                           std::min(ref.length, data.GetLength()));
+        }
+        sources[i] = bv.GetCodeReferences(ref.start);
+    });
+
+    // Number the referencing functions in start-address order so
+    // per-function results come out sorted without another pass.
+    std::map<std::pair<uint64_t, BNFunction*>, Ref<Function>> byStart;
+    for (const auto& refs : sources) {
+        for (const ReferenceSource& src : refs) {
+            if (!src.func) continue;
+            byStart.emplace(
+                std::make_pair(src.func->GetStart(), src.func->GetObject()),
+                src.func);
+        }
+    }
+    si.functions.clear();
+    si.functionIndex.clear();
+    for (auto& [key, func] : byStart) {
+        si.functionIndex.emplace(func->GetObject(),
+                                 static_cast<uint32_t>(si.functions.size()));
+        si.functions.push_back(func);
+    }
+
+    si.refs.clear();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (const ReferenceSource& src : sources[i]) {
+            if (!src.func) continue;
+            auto it = si.functionIndex.find(src.func->GetObject());
+            if (it == si.functionIndex.end()) continue;
+            si.refs.push_back({it->second, static_cast<uint32_t>(i),
+                               src.addr});
+        }
+    }
+    std::sort(si.refs.begin(), si.refs.end(),
+              [](const StringReference& a, const StringReference& b) {
+                  if (a.func != b.func) return a.func < b.func;
+                  if (a.string != b.string) return a.string < b.string;
+                  return a.address < b.address;
+              });
+    si.refs.erase(std::unique(si.refs.begin(), si.refs.end(),
+                              [](const StringReference& a,
+                                 const StringReference& b) {
+                                  return a.func == b.func &&
+                                         a.string == b.string &&
+                                         a.address == b.address;
+                              }),
+                  si.refs.end());
+    si.strings = std::move(strings);
+    si.functionsGeneration = funcGen;
+    si.stringsGeneration = strGen;
+}
+
+// Emit one {addr, length, type, value, refs} entry per string for the
+// run of refs [first, last) that belongs to a single function. Shape
+// extends the bv:strings() entries with the referencing addresses.
+sol::table FunctionStringsToTable(
+    sol::state_view lua, const StringIndex& si,
+    std::vector<StringReference>::const_iterator first,
+    std::vector<StringReference>::const_iterator last,
+    const std::vector<bool>* matched) {
+    sol::table result = lua.create_table();
+    int idx = 1;
+    auto it = first;
+    while (it != last) {
+        const uint32_t sidx = it->string;
+        auto runEnd = it;
+        while (runEnd != last && runEnd->string == sidx) ++runEnd;
+        if (!matched || (*matched)[sidx]) {
+            const IndexedString& s = si.strings[sidx];
+            sol::table entry = lua.create_table(0, 5);
+            entry["addr"] = HexAddress(s.start);
+            entry["length"] = s.length;
+            entry["type"] = s.type;
+            entry["value"] = s.value;
+            sol::table refs = lua.create_table(
+                static_cast<int>(std::distance(it, runEnd)), 0);
+            int r = 1;
+            for (auto ref = it; ref != runEnd; ++ref) {
+                refs[r++] = HexAddress(ref->address);
+            }
+            entry["refs"] = refs;
+            result[idx++] = entry;
+        }
+        it = runEnd;
+    }
+    return result;
+}
+
+std::string ToLower(std::string s) {
+    for (char& c : s) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return s;
+}
+
+uint32_t PackTrigram(const char* p) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(p[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(p[2])) << 16;
+}
+
+// Names change through symbol notifications as well as function
+// add / remove, and are cheap to collect, so the index is rebuilt whole
+// when either generation moves.
+void RefreshNameIndex(ViewIndex& index, BinaryView& bv) {
+    NameIndex& ni = index.names;
+    const uint64_t funcGen = index.FunctionsGeneration();
+    const uint64_t symGen = index.SymbolsGeneration();
+    if (funcGen == ni.functionsGeneration &&
+        symGen == ni.symbolsGeneration) {
+        return;
+    }
+
+    std::vector<Ref<Function>> funcs = bv.GetAnalysisFunctionList();
+    std::sort(funcs.begin(), funcs.end(),
+              [](const Ref<Function>& a, const Ref<Function>& b) {
+                  const uint64_t sa = a->GetStart(), sb = b->GetStart();
+                  return sa != sb ? sa < sb : a->GetObject() < b->GetObject();
+              });
+    std::vector<std::string> names(funcs.size());
+    std::vector<std::string> lowered(funcs.size());
+    ParallelFor(funcs.size(), [&](size_t i) {
+        names[i] = funcs[i]->GetSymbol()->GetShortName();
+        lowered[i] = ToLower(names[i]);
+    });
+
+    ni.exact.clear();
+    ni.trigrams.clear();
+    ni.sorted.resize(funcs.size());
+    for (uint32_t i = 0; i < funcs.size(); ++i) {
+        const std::string& name = lowered[i];
+        ni.exact[name].push_back(i);
+        ni.sorted[i] = i;
+        for (size_t k = 0; k + 3 <= name.size(); ++k) {
+            auto& postings = ni.trigrams[PackTrigram(name.data() + k)];
+            // A name repeating a trigram is listed once.
+            if (postings.empty() || postings.back() != i) {
+                postings.push_back(i);
+            }
+        }
+    }
+    std::sort(ni.sorted.begin(), ni.sorted.end(),
+              [&](uint32_t a, uint32_t b) { return lowered[a] < lowered[b]; });
+
+    ni.functions = std::move(funcs);
+    ni.names = std::move(names);
+    ni.lowered = std::move(lowered);
+    ni.functionsGeneration = funcGen;
+    ni.symbolsGeneration = symGen;
+}
+
+// Functions whose lower-cased name contains every trigram of needle
+// (itself lower-cased, at least 3 bytes). A superset of the real
+// matches; callers verify each candidate.
+std::vector<uint32_t> TrigramCandidates(const NameIndex& ni,
+                                        const std::string& needle) {
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t k = 0; k + 3 <= needle.size(); ++k) {
+        auto it = ni.trigrams.find(PackTrigram(needle.data() + k));
+        if (it == ni.trigrams.end()) return {};
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    std::vector<uint32_t> result = *lists.front();
+    std::vector<uint32_t> scratch;
+    for (size_t l = 1; l < lists.size() && !result.empty(); ++l) {
+        scratch.clear();
+        std::set_intersection(result.begin(), result.end(),
+                              lists[l]->begin(), lists[l]->end(),
+                              std::back_inserter(scratch));
+        result.swap(scratch);
+    }
+    return result;
+}
+
+// Longest literal run that every match of an ECMAScript pattern must
+// contain, or "" when none can be proven. Deliberately conservative:
+// top-level alternation gives up, groups and bracket expressions end
+// the current run, and a quantified atom is dropped from it.
+std::string RequiredRegexLiteral(const std::string& pattern) {
+    std::string best;
+    std::string run;
+    auto flush = [&]() {
+        if (run.size() > best.size()) best = run;
+        run.clear();
+    };
+
+    size_t i = 0;
+    const size_t n = pattern.size();
+    while (i < n) {
+        const char c = pattern[i];
+        switch (c) {
+            case '|':
+                return {};
+            case '\\': {
+                if (i + 1 < n &&
+                    !std::isalnum(static_cast<unsigned char>(pattern[i + 1]))) {
+                    run.push_back(pattern[i + 1]);
+                    i += 2;
+                    continue;
+                }
+                // Class, control, hex, unicode and back-reference escapes
+                // end the run; their arguments (\xHH, \uHHHH, \cX, \12)
+                // are skipped so they are not read as literal text.
+                flush();
+                const char e = i + 1 < n ? pattern[i + 1] : '\0';
+                i += 2;
+                auto skip = [&](size_t width, auto isArg) {
+                    for (; width > 0 && i < n &&
+                           isArg(static_cast<unsigned char>(pattern[i]));
+                         --width) {
+                        ++i;
+                    }
+                };
+                if (e == 'x') {
+                    skip(2, [](unsigned char d) { return std::isxdigit(d); });
+                } else if (e == 'u') {
+                    skip(4, [](unsigned char d) { return std::isxdigit(d); });
+                } else if (e == 'c') {
+                    skip(1, [](unsigned char d) { return std::isalpha(d); });
+                } else if (std::isdigit(static_cast<unsigned char>(e))) {
+                    skip(n, [](unsigned char d) { return std::isdigit(d); });
+                }
+                continue;
+            }
+            case '[':
+                flush();
+                ++i;
+                if (i < n && pattern[i] == '^') ++i;
+                if (i < n && pattern[i] == ']') ++i;
+                while (i < n && pattern[i] != ']') {
+                    if (pattern[i] == '\\') ++i;
+                    ++i;
+                }
+                ++i;
+                continue;
+            case '(': {
+                flush();
+                int depth = 0;
+                for (; i < n; ++i) {
+                    if (pattern[i] == '\\') {
+                        ++i;
+                    } else if (pattern[i] == '(') {
+                        ++depth;
+                    } else if (pattern[i] == ')' && --depth == 0) {
+                        break;
+                    }
+                }
+                ++i;
+                continue;
+            }
+            case '?':
+            case '*':
+            case '{':
+                // The preceding atom may be absent.
+                if (!run.empty()) run.pop_back();
+                flush();
+                if (c == '{') {
+                    while (i < n && pattern[i] != '}') ++i;
+                }
+                ++i;
+                // Lazy suffix.
+                if (i < n && pattern[i] == '?') ++i;
+                continue;
+            case '+':
+                flush();
+                ++i;
+                if (i < n && pattern[i] == '?') ++i;
+                continue;
+            case '.':
+            case '^':
+            case '$':
+            case ')':
+                flush();
+                ++i;
+                continue;
+            default:
+                run.push_back(c);
+                ++i;
+                continue;
+        }
+    }
+    flush();
+    return best;
+}
+
+// Bounds the queue between symbol-partition queries; past this a
+// rebuild is cheaper than replaying the changes one insert at a time.
+constexpr size_t kMaxQueuedSymbolChanges = 1 << 16;
+
+bool SymbolLess(const IndexedSymbol& a, const IndexedSymbol& b) {
+    return a.address != b.address ? a.address < b.address
+                                   : a.rawName < b.rawName;
+}
+
+// Insert or replace by (address, raw name). Idempotent, so changes
+// already contained in the snapshot can be replayed safely.
+void InsertSymbol(std::vector<IndexedSymbol>& part, IndexedSymbol entry) {
+    auto it = std::lower_bound(part.begin(), part.end(), entry, SymbolLess);
+    if (it != part.end() && it->address == entry.address &&
+        it->rawName == entry.rawName) {
+        it->symbol = std::move(entry.symbol);
+    } else {
+        part.insert(it, std::move(entry));
+    }
+}
+
+void EraseSymbol(std::vector<IndexedSymbol>& part,
+                 const IndexedSymbol& entry) {
+    auto it = std::lower_bound(part.begin(), part.end(), entry, SymbolLess);
+    if (it != part.end() && it->address == entry.address &&
+        it->rawName == entry.rawName) {
+        part.erase(it);
+    }
+}
+
+void RefreshSymbolIndex(ViewIndex& index, BinaryView& bv) {
+    SymbolIndex& si = index.symbols;
+    std::vector<SymbolChange> changes;
+    if (si.built && index.TakeSymbolChanges(changes)) {
+        for (const SymbolChange& change : changes) {
+            IndexedSymbol entry{change.symbol->GetAddress(),
+                                change.symbol->GetRawName(), change.symbol};
+            auto& part = si.byType[change.symbol->GetType()];
+            if (change.added) {
+                InsertSymbol(part, std::move(entry));
+            } else {
+                EraseSymbol(part, entry);
+            }
+        }
+        return;
+    }
+
+    index.BeginSymbolSnapshot();
+    std::vector<Ref<Symbol>> all = bv.GetSymbols();
+    std::vector<IndexedSymbol> entries(all.size());
+    std::vector<BNSymbolType> types(all.size());
+    ParallelFor(all.size(), [&](size_t i) {
+        entries[i] = {all[i]->GetAddress(), all[i]->GetRawName(), all[i]};
+        types[i] = all[i]->GetType();
+    });
+    si.byType.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        si.byType[types[i]].push_back(std::move(entries[i]));
+    }
+    for (auto& [type, part] : si.byType) {
+        std::sort(part.begin(), part.end(), SymbolLess);
+    }
+    si.built = true;
+}
+
+// Symbols of several types merged into address order.
+std::vector<Ref<Symbol>> MergedSymbols(
+    const SymbolIndex& si, std::initializer_list<BNSymbolType> types) {
+    std::vector<const IndexedSymbol*> merged;
+    for (BNSymbolType type : types) {
+        auto it = si.byType.find(type);
+        if (it == si.byType.end()) continue;
+        const size_t mid = merged.size();
+        for (const IndexedSymbol& entry : it->second) merged.push_back(&entry);
+        std::inplace_merge(merged.begin(), merged.begin() + mid, merged.end(),
+                           [](const IndexedSymbol* a, const IndexedSymbol* b) {
+                               return a->address < b->address;
+                           });
+    }
+    std::vector<Ref<Symbol>> result;
+    result.reserve(merged.size());
+    for (const IndexedSymbol* entry : merged) result.push_back(entry->symbol);
+    return result;
+}
+
+std::vector<BlockInterval> ScanFunctionBlocks(const Ref<Function>& func) {
+    std::vector<BlockInterval> out;
+    for (const Ref<BasicBlock>& block : func->GetBasicBlocks()) {
+        out.push_back({block->GetStart(), block->GetEnd(), block, 0});
+    }
+    return out;
+}
+
+void RefreshAddressIndex(ViewIndex& index, BinaryView& bv, bool withTags) {
+    AddressIndex& ai = index.addresses;
+    if (ai.blockSlices.Refresh(index, bv, ScanFunctionBlocks)) {
+        ai.blocks.items.clear();
+        for (size_t f = 0; f < ai.blockSlices.functions.size(); ++f) {
+            const auto* slice =
+                ai.blockSlices.Find(ai.blockSlices.functions[f]->GetObject());
+            if (!slice) continue;
+            for (BlockInterval interval : *slice) {
+                interval.func = static_cast<uint32_t>(f);
+                ai.blocks.items.push_back(std::move(interval));
+            }
+        }
+        ai.blocks.Finish();
+    }
+
+    const uint64_t dataGen = index.DataVariablesGeneration();
+    if (dataGen != ai.dataVariablesGeneration) {
+        ai.dataVariables.items.clear();
+        for (const auto& [addr, var] : bv.GetDataVariables()) {
+            // Untyped / zero-width variables still own their start byte.
+            uint64_t width = var.type.GetValue() ? var.type->GetWidth() : 0;
+            ai.dataVariables.items.push_back(
+                {addr, addr + std::max<uint64_t>(width, 1), var});
+        }
+        ai.dataVariables.Finish();
+        ai.dataVariablesGeneration = dataGen;
+    }
+
+    const uint64_t sectionGen = index.SectionsGeneration();
+    if (sectionGen != ai.sectionsGeneration) {
+        ai.sections.items.clear();
+        for (const Ref<Section>& section : bv.GetSections()) {
+            ai.sections.items.push_back(
+                {section->GetStart(),
+                 section->GetStart() + section->GetLength(), section});
+        }
+        ai.sections.Finish();
+        ai.sectionsGeneration = sectionGen;
+    }
+
+    const uint64_t tagGen = index.TagsGeneration();
+    if (withTags && tagGen != ai.tagsGeneration) {
+        ai.tags = bv.GetDataTagsInRange(0, ~0ULL);
+        std::sort(ai.tags.begin(), ai.tags.end(),
+                  [](const TagReference& a, const TagReference& b) {
+                      return a.addr < b.addr;
+                  });
+        ai.tagsGeneration = tagGen;
+    }
+}
+
+// Reference kinds accepted by bv:xrefs_batch, named after the
+// single-address methods whose results they reproduce.
+enum class XrefKind : uint8_t {
+    CodeRefs,
+    DataRefs,
+    CodeRefsFrom,
+    DataRefsFrom,
+    Callers,
+    Callees,
+};
+
+constexpr std::pair<const char*, XrefKind> kXrefKinds[] = {
+    {"code_refs", XrefKind::CodeRefs},
+    {"data_refs", XrefKind::DataRefs},
+    {"code_refs_from", XrefKind::CodeRefsFrom},
+    {"data_refs_from", XrefKind::DataRefsFrom},
+    {"callers", XrefKind::Callers},
+    {"callees", XrefKind::Callees},
+};
+
+const char* XrefKindName(XrefKind kind) {
+    for (const auto& [name, k] : kXrefKinds) {
+        if (k == kind) return name;
+    }
+    return "unknown";
+}
+
+struct XrefRow {
+    uint64_t from;
+    uint64_t to;
+    Ref<Function> func;
+    XrefKind kind;
+};
+
+// One address, one kind; mirrors the matching get_* binding so batch
+// and single-address results agree.
+void CollectXrefs(BinaryView& bv, uint64_t addr, XrefKind kind,
+                  std::vector<XrefRow>& out) {
+    auto fromSource = [&]() {
+        ReferenceSource src;
+        src.addr = addr;
+        src.arch = bv.GetDefaultArchitecture();
+        src.func = bv.GetAnalysisFunction(bv.GetDefaultPlatform(), addr);
+        return src;
+    };
+    switch (kind) {
+        case XrefKind::CodeRefs:
+            for (const ReferenceSource& src : bv.GetCodeReferences(addr)) {
+                out.push_back({src.addr, addr, src.func, kind});
+            }
+            break;
+        case XrefKind::DataRefs:
+            for (uint64_t from : bv.GetDataReferences(addr)) {
+                out.push_back({from, addr, nullptr, kind});
+            }
+            break;
+        case XrefKind::CodeRefsFrom: {
+            ReferenceSource src = fromSource();
+            for (uint64_t to : bv.GetCodeReferencesFrom(src)) {
+                out.push_back({addr, to, src.func, kind});
+            }
+            break;
+        }
+        case XrefKind::DataRefsFrom:
+            for (uint64_t to : bv.GetDataReferencesFrom(addr)) {
+                out.push_back({addr, to, nullptr, kind});
+            }
+            break;
+        case XrefKind::Callers:
+            for (const ReferenceSource& src : bv.GetCallers(addr)) {
+                out.push_back({src.addr, addr, src.func, kind});
+            }
+            break;
+        case XrefKind::Callees: {
+            ReferenceSource src = fromSource();
+            for (uint64_t to : bv.GetCallees(src)) {
+                out.push_back({addr, to, src.func, kind});
+            }
+            break;
+        }
+    }
+}
+
+CallSlice ScanFunctionCalls(const Ref<Function>& func) {
+    CallSlice slice;
+    Ref<Platform> platform = func->GetPlatform();
+    slice.platform = platform ? platform->GetObject() : nullptr;
+    Ref<BinaryView> view = func->GetView();
+    for (const ReferenceSource& site : func->GetCallSites()) {
+        for (uint64_t target : view->GetCallees(site)) {
+            slice.targets.push_back(target);
+        }
+    }
+    return slice;
+}
+
+// Fill offsets / adjacency / per-edge site counts from (node, neighbour)
+// pairs sorted by node then neighbour.
+void BuildCsr(size_t nodes,
+              const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+              std::vector<uint32_t>& offsets, std::vector<uint32_t>& adj,
+              std::vector<uint32_t>& sites, std::vector<uint32_t>& totals) {
+    offsets.assign(nodes + 1, 0);
+    adj.clear();
+    sites.clear();
+    totals.assign(nodes, 0);
+    for (size_t k = 0; k < pairs.size();) {
+        size_t run = k;
+        while (run < pairs.size() && pairs[run] == pairs[k]) ++run;
+        const uint32_t node = pairs[k].first;
+        adj.push_back(pairs[k].second);
+        sites.push_back(static_cast<uint32_t>(run - k));
+        ++offsets[node + 1];
+        totals[node] += static_cast<uint32_t>(run - k);
+        k = run;
+    }
+    for (size_t i = 0; i < nodes; ++i) offsets[i + 1] += offsets[i];
+}
+
+std::shared_ptr<CallGraph> BuildCallGraph(
+    const FunctionSliceCache<CallSlice>& slices) {
+    auto graph = std::make_shared<CallGraph>();
+    graph->functions = slices.functions;
+    std::sort(graph->functions.begin(), graph->functions.end(),
+              [](const Ref<Function>& a, const Ref<Function>& b) {
+                  const uint64_t sa = a->GetStart(), sb = b->GetStart();
+                  return sa != sb ? sa < sb : a->GetObject() < b->GetObject();
+              });
+    const size_t n = graph->functions.size();
+
+    // Resolve callees the way Function.calls always has: the function
+    // starting at the target on the caller's platform. A target that
+    // only starts a function on another platform stays an unresolved
+    // entry in targets and gets no callee edge. Caller edges follow
+    // BinaryView::GetCallers instead and are recorded for every
+    // function starting at the target, so Function.callers still sees
+    // interworking (e.g. ARM -> Thumb) calls.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> byStart;
+    std::vector<const CallSlice*> nodeSlices(n);
+    graph->index.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        BNFunction* key = graph->functions[i]->GetObject();
+        graph->index.emplace(key, i);
+        byStart[graph->functions[i]->GetStart()].push_back(i);
+        nodeSlices[i] = slices.Find(key);
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<std::pair<uint32_t, uint32_t>> callerEdges;
+    graph->targetOffsets.assign(n + 1, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        const CallSlice* slice = nodeSlices[i];
+        if (!slice) {
+            graph->targetOffsets[i + 1] = graph->targetOffsets[i];
+            continue;
+        }
+        for (uint64_t target : slice->targets) {
+            auto it = byStart.find(target);
+            if (it == byStart.end()) continue;
+            bool resolved = false;
+            for (uint32_t candidate : it->second) {
+                callerEdges.emplace_back(candidate, i);
+                const CallSlice* cs = nodeSlices[candidate];
+                if (!resolved && cs && cs->platform == slice->platform) {
+                    edges.emplace_back(i, candidate);
+                    resolved = true;
+                }
+            }
+        }
+        const size_t first = graph->targets.size();
+        graph->targets.insert(graph->targets.end(), slice->targets.begin(),
+                              slice->targets.end());
+        std::sort(graph->targets.begin() + first, graph->targets.end());
+        graph->targets.erase(
+            std::unique(graph->targets.begin() + first, graph->targets.end()),
+            graph->targets.end());
+        graph->targetOffsets[i + 1] =
+            static_cast<uint32_t>(graph->targets.size());
+    }
+
+    std::sort(edges.begin(), edges.end());
+    BuildCsr(n, edges, graph->calleeOffsets, graph->callees,
+             graph->calleeSites, graph->outSites);
+    std::sort(callerEdges.begin(), callerEdges.end());
+    BuildCsr(n, callerEdges, graph->callerOffsets, graph->callers,
+             graph->callerSites, graph->inSites);
+    return graph;
+}
+
+// Iterative Tarjan; call graphs are deep enough to overflow the native
+// stack with the recursive formulation.
+std::unique_ptr<CallGraphComponents> ComputeComponents(const CallGraph& g) {
+    constexpr uint32_t kUnvisited = ~0U;
+    const size_t n = g.NodeCount();
+    auto comps = std::make_unique<CallGraphComponents>();
+    comps->id.assign(n, kUnvisited);
+
+    std::vector<uint32_t> order(n, kUnvisited);
+    std::vector<uint32_t> low(n, 0);
+    std::vector<uint8_t> onStack(n, 0);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> frames;  // (node, next edge)
+    std::vector<std::vector<uint32_t>> members;
+    uint32_t counter = 0;
+
+    for (uint32_t root = 0; root < n; ++root) {
+        if (order[root] != kUnvisited) continue;
+        auto enter = [&](uint32_t v) {
+            order[v] = low[v] = counter++;
+            stack.push_back(v);
+            onStack[v] = 1;
+            frames.emplace_back(v, g.calleeOffsets[v]);
+        };
+        enter(root);
+        while (!frames.empty()) {
+            auto& [v, e] = frames.back();
+            if (e < g.calleeOffsets[v + 1]) {
+                const uint32_t w = g.callees[e++];
+                if (order[w] == kUnvisited) {
+                    enter(w);
+                } else if (onStack[w]) {
+                    low[v] = std::min(low[v], order[w]);
+                }
+                continue;
+            }
+            const uint32_t done = v;
+            frames.pop_back();
+            if (low[done] == order[done]) {
+                const uint32_t c = static_cast<uint32_t>(members.size());
+                members.emplace_back();
+                uint32_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    comps->id[w] = c;
+                    members.back().push_back(w);
+                } while (w != done);
+            }
+            if (!frames.empty()) {
+                uint32_t parent = frames.back().first;
+                low[parent] = std::min(low[parent], low[done]);
+            }
+        }
+    }
+
+    const size_t count = members.size();
+    comps->offsets.assign(count + 1, 0);
+    comps->dagOffsets.assign(count + 1, 0);
+    comps->recursive.assign(count, 0);
+    comps->height.assign(count, 0);
+    std::vector<uint32_t> succ;
+    for (uint32_t c = 0; c < count; ++c) {
+        auto& m = members[c];
+        std::sort(m.begin(), m.end());
+        comps->nodes.insert(comps->nodes.end(), m.begin(), m.end());
+        comps->offsets[c + 1] = static_cast<uint32_t>(comps->nodes.size());
+        comps->recursive[c] = m.size() > 1;
+
+        succ.clear();
+        for (uint32_t v : m) {
+            for (uint32_t e = g.calleeOffsets[v]; e < g.calleeOffsets[v + 1];
+                 ++e) {
+                const uint32_t w = g.callees[e];
+                if (w == v) comps->recursive[c] = 1;
+                if (comps->id[w] != c) succ.push_back(comps->id[w]);
+            }
+        }
+        std::sort(succ.begin(), succ.end());
+        succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+        // Successors complete before c, so their heights are final.
+        for (uint32_t d : succ) {
+            comps->height[c] = std::max(comps->height[c], comps->height[d] + 1);
+        }
+        comps->dag.insert(comps->dag.end(), succ.begin(), succ.end());
+        comps->dagOffsets[c + 1] = static_cast<uint32_t>(comps->dag.size());
+    }
+    return comps;
+}
+
+// Nodes in component order: callers before callees, or callees first
+// when bottomUp.
+std::vector<uint32_t> TopologicalOrder(const CallGraph& g, bool bottomUp) {
+    const CallGraphComponents& comps = g.Components();
+    std::vector<uint32_t> out;
+    out.reserve(g.NodeCount());
+    const size_t count = comps.Count();
+    for (size_t k = 0; k < count; ++k) {
+        const size_t c = bottomUp ? k : count - 1 - k;
+        out.insert(out.end(), comps.nodes.begin() + comps.offsets[c],
+                   comps.nodes.begin() + comps.offsets[c + 1]);
+    }
+    return out;
+}
+
+// Shortest (BFS over calls) and longest (over the condensation DAG,
+// recursion groups counted once) call depth of every node from the
+// roots; -1 where no root reaches the node. Default roots are the
+// members of components nothing else calls.
+void CallDepths(const CallGraph& g, std::vector<uint32_t> roots,
+                std::vector<int64_t>& shortest,
+                std::vector<int64_t>& longest) {
+    const CallGraphComponents& comps = g.Components();
+    const size_t n = g.NodeCount();
+    const size_t count = comps.Count();
+    if (roots.empty()) {
+        std::vector<uint8_t> called(count, 0);
+        for (uint32_t d : comps.dag) called[d] = 1;
+        for (uint32_t c = 0; c < count; ++c) {
+            if (called[c]) continue;
+            roots.insert(roots.end(), comps.nodes.begin() + comps.offsets[c],
+                         comps.nodes.begin() + comps.offsets[c + 1]);
+        }
+    }
+
+    shortest.assign(n, -1);
+    std::vector<uint32_t> queue;
+    for (uint32_t r : roots) {
+        if (shortest[r] == 0) continue;
+        shortest[r] = 0;
+        queue.push_back(r);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t v = queue[head];
+        for (uint32_t e = g.calleeOffsets[v]; e < g.calleeOffsets[v + 1]; ++e) {
+            const uint32_t w = g.callees[e];
+            if (shortest[w] != -1) continue;
+            shortest[w] = shortest[v] + 1;
+            queue.push_back(w);
+        }
+    }
+
+    std::vector<int64_t> compDepth(count, -1);
+    for (uint32_t r : roots) compDepth[comps.id[r]] = 0;
+    // Descending ids visit every caller component before its callees.
+    for (size_t k = count; k-- > 0;) {
+        if (compDepth[k] < 0) continue;
+        for (uint32_t e = comps.dagOffsets[k]; e < comps.dagOffsets[k + 1];
+             ++e) {
+            int64_t& d = compDepth[comps.dag[e]];
+            d = std::max(d, compDepth[k] + 1);
+        }
+    }
+    longest.resize(n);
+    for (size_t v = 0; v < n; ++v) longest[v] = compDepth[comps.id[v]];
+}
+
+// Nodes reachable from start through at least one call (callers when
+// reverse), at most maxDepth calls away (0 = unbounded). Ascending.
+std::vector<uint32_t> Reachable(const CallGraph& g, uint32_t start,
+                                bool reverse, size_t maxDepth) {
+    const auto& offsets = reverse ? g.callerOffsets : g.calleeOffsets;
+    const auto& adj = reverse ? g.callers : g.callees;
+    std::vector<uint32_t> depth(g.NodeCount(), 0);
+    std::vector<uint8_t> seen(g.NodeCount(), 0);
+    std::vector<uint32_t> queue;
+    auto expand = [&](uint32_t v, uint32_t d) {
+        if (maxDepth != 0 && d >= maxDepth) return;
+        for (uint32_t e = offsets[v]; e < offsets[v + 1]; ++e) {
+            const uint32_t w = adj[e];
+            if (seen[w]) continue;
+            seen[w] = 1;
+            depth[w] = d + 1;
+            queue.push_back(w);
+        }
+    };
+    expand(start, 0);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        expand(queue[head], depth[queue[head]]);
+    }
+    std::sort(queue.begin(), queue.end());
+    return queue;
+}
+
+// Simple call paths from -> to with at most maxLength calls, stopping
+// after maxPaths results.
+std::vector<std::vector<uint32_t>> SimplePaths(const CallGraph& g,
+                                               uint32_t from, uint32_t to,
+                                               size_t maxLength,
+                                               size_t maxPaths) {
+    std::vector<std::vector<uint32_t>> out;
+    if (from == to) {
+        out.push_back({from});
+        return out;
+    }
+    std::vector<uint8_t> onPath(g.NodeCount(), 0);
+    std::vector<uint32_t> path{from};
+    std::vector<uint32_t> next{g.calleeOffsets[from]};
+    onPath[from] = 1;
+    while (!path.empty() && out.size() < maxPaths) {
+        const uint32_t v = path.back();
+        uint32_t& e = next.back();
+        if (path.size() > maxLength || e == g.calleeOffsets[v + 1]) {
+            onPath[v] = 0;
+            path.pop_back();
+            next.pop_back();
+            continue;
+        }
+        const uint32_t w = g.callees[e++];
+        if (onPath[w]) continue;
+        if (w == to) {
+            out.push_back(path);
+            out.back().push_back(w);
+            continue;
+        }
+        path.push_back(w);
+        next.push_back(g.calleeOffsets[w]);
+        onPath[w] = 1;
+    }
+    return out;
+}
+
+bool IsExportedSymbol(const Ref<Symbol>& sym) {
+    if (!sym) return false;
+    BNSymbolBinding binding = sym->GetBinding();
+    return binding == GlobalBinding || binding == WeakBinding;
+}
+
+FunctionSummary ComputeFunctionSummary(Function& func) {
+    FunctionSummary summary;
+    // Edge, complexity and loop figures come from the same CSR snapshot
+    // as func:cfg_analytics(), so the two never disagree.
+    const FunctionCfg cfg = BuildFunctionCfg(func);
+    Ref<BinaryView> view = func.GetView();
+    summary.blockCount = cfg.BlockCount();
+    summary.edgeCount = cfg.EdgeCount();
+    summary.cyclomaticComplexity = cfg.CyclomaticComplexity();
+    for (uint32_t u : cfg.rpo) {
+        for (uint32_t e = cfg.succOffsets[u]; e < cfg.succOffsets[u + 1]; ++e) {
+            if (cfg.rpoIndex[cfg.succs[e]] <= cfg.rpoIndex[u]) {
+                summary.hasLoops = true;
+            }
+        }
+    }
+    for (const Ref<BasicBlock>& block : cfg.blocks) {
+        Ref<Architecture> arch = block->GetArchitecture();
+        if (!view || !arch) continue;
+        for (uint64_t addr = block->GetStart(); addr < block->GetEnd();) {
+            size_t len = view->GetInstructionLength(arch, addr);
+            addr += len ? len : 1;
+            ++summary.instructionCount;
+        }
+    }
+    summary.isExported = IsExportedSymbol(func.GetSymbol());
+    // A tailcall thunk is a single native block; anything larger is
+    // ruled out without generating LLIL.
+    summary.isThunk = cfg.BlockCount() == 1 && FunctionIsThunk(func);
+    return summary;
+}
+
+sol::table SummaryToTable(sol::state_view lua, const FunctionSummary& s) {
+    sol::table t = lua.create_table(0, 7);
+    t["block_count"] = s.blockCount;
+    t["edge_count"] = s.edgeCount;
+    t["instruction_count"] = s.instructionCount;
+    t["cyclomatic_complexity"] = s.cyclomaticComplexity;
+    t["is_thunk"] = s.isThunk;
+    t["is_exported"] = s.isExported;
+    t["has_loops"] = s.hasLoops;
+    return t;
+}
+
+// Drop cache entries of functions that left the view. Only runs once
+// the map has outgrown the last known function count, so the
+// GetAnalysisFunctionList() call is amortized.
+template <typename Map>
+void PruneRemovedFunctions(Map& entries, size_t& liveCount, BinaryView& bv) {
+    if (entries.size() <= 2 * liveCount + 64) return;
+    std::vector<Ref<Function>> live = bv.GetAnalysisFunctionList();
+    std::unordered_set<BNFunction*> keep;
+    keep.reserve(live.size());
+    for (const Ref<Function>& func : live) keep.insert(func->GetObject());
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = keep.count(it->first) ? std::next(it) : entries.erase(it);
+    }
+    liveCount = live.size();
+}
+
+uint32_t InternMnemonic(InstructionCache& cache, const std::string& name) {
+    auto [it, inserted] = cache.mnemonicIds.emplace(
+        name, static_cast<uint32_t>(cache.mnemonicNames.size()));
+    if (inserted) cache.mnemonicNames.push_back(name);
+    return it->second;
+}
+
+// One ReadBuffer per block. Without mnemonics each instruction is only
+// length-decoded; with them it is decoded once for both its length and
+// its mnemonic, which intern(name) maps to an id. Undecodable bytes
+// fall back to the view's instruction length (or 1) so the walk always
+// advances.
+template <typename Intern>
+std::shared_ptr<FunctionInstructions> DecodeFunctionInstructions(
+    Function& func, BinaryView& view, bool mnemonics, Intern&& intern) {
+    auto decoded = std::make_shared<FunctionInstructions>();
+    decoded->hasMnemonics = mnemonics;
+    for (const Ref<BasicBlock>& block : func.GetBasicBlocks()) {
+        Ref<Architecture> arch = block->GetArchitecture();
+        const uint64_t start = block->GetStart();
+        const uint64_t end = block->GetEnd();
+        BlockInstructions& out = decoded->blocks[start];
+        if (!arch || end <= start) continue;
+
+        DataBuffer data = view.ReadBuffer(start, end - start);
+        const uint8_t* bytes = static_cast<const uint8_t*>(data.GetData());
+        const size_t available = data.GetLength();
+        std::vector<InstructionTextToken> tokens;
+        InstructionInfo info;
+        for (uint64_t addr = start; addr < end;) {
+            const size_t offset = static_cast<size_t>(addr - start);
+            const size_t maxLen = offset < available ? available - offset : 0;
+            size_t len = 0;
+            uint32_t mnemonic = 0;
+            if (mnemonics) {
+                tokens.clear();
+                len = maxLen;
+                if (!len || !arch->GetInstructionText(bytes + offset, addr,
+                                                      len, tokens)) {
+                    len = 0;
+                }
+                for (const auto& token : tokens) {
+                    if (token.type == InstructionToken) {
+                        mnemonic = intern(token.text);
+                        break;
+                    }
+                }
+            } else if (maxLen &&
+                       arch->GetInstructionInfo(bytes + offset, addr, maxLen,
+                                                info)) {
+                len = info.length;
+            }
+            if (len == 0) len = view.GetInstructionLength(arch, addr);
+            if (len == 0) len = 1;
+            out.addresses.push_back(addr);
+            out.lengths.push_back(static_cast<uint16_t>(
+                std::min<size_t>(len, std::numeric_limits<uint16_t>::max())));
+            if (mnemonics) out.mnemonics.push_back(mnemonic);
+            addr += len;
+        }
+    }
+    return decoded;
+}
+
+// BinaryView.opcode_histogram. Each worker produces one sparse
+// (name, count) list per function; nothing touches Lua until they
+// have joined.
+using OpcodeCounts = std::vector<std::pair<std::string, uint64_t>>;
+
+template <typename Operation>
+OpcodeCounts DenseToSparse(const std::vector<uint64_t>& dense) {
+    OpcodeCounts out;
+    for (size_t op = 0; op < dense.size(); ++op) {
+        if (dense[op]) {
+            out.emplace_back(EnumToString(static_cast<Operation>(op)),
+                             dense[op]);
+        }
+    }
+    return out;
+}
+
+template <typename Instruction>
+void CountOperations(const Instruction& instr, bool nested,
+                     std::vector<uint64_t>& dense) {
+    auto bump = [&](size_t op) {
+        if (op >= dense.size()) dense.resize(op + 1);
+        ++dense[op];
+    };
+    if (!nested) {
+        bump(instr.operation);
+        return;
+    }
+    instr.VisitExprs([&](const Instruction& expr) -> bool {
+        bump(expr.operation);
+        return true;
+    });
+}
+
+template <typename IL, typename Operation>
+OpcodeCounts CountILFunction(const Ref<IL>& il, bool nested) {
+    std::vector<uint64_t> dense;
+    if (!il) return {};
+    const size_t count = il->GetInstructionCount();
+    for (size_t i = 0; i < count; ++i) {
+        CountOperations(il->GetInstruction(i), nested, dense);
+    }
+    return DenseToSparse<Operation>(dense);
+}
+
+OpcodeCounts CountFunctionOpcodes(const Ref<Function>& func, BinaryView& bv,
+                                  const std::string& level, bool nested) {
+    if (level == "llil") {
+        return CountILFunction<LowLevelILFunction, BNLowLevelILOperation>(
+            func->GetLowLevelIL(), nested);
+    }
+    if (level == "mlil") {
+        return CountILFunction<MediumLevelILFunction,
+                               BNMediumLevelILOperation>(
+            func->GetMediumLevelIL(), nested);
+    }
+    if (level == "hlil") {
+        // HLIL statements nest (blocks, if / loop bodies), so counting
+        // every expression walks the tree once from the root instead.
+        Ref<HighLevelILFunction> il = func->GetHighLevelIL();
+        if (!il) return {};
+        if (!nested) {
+            return CountILFunction<HighLevelILFunction,
+                                   BNHighLevelILOperation>(il, false);
+        }
+        std::vector<uint64_t> dense;
+        CountOperations(il->GetRootExpr(), true, dense);
+        return DenseToSparse<BNHighLevelILOperation>(dense);
+    }
+
+    // "disasm": mnemonics with function-local ids.
+    std::vector<std::string> names{"<unknown>"};
+    std::unordered_map<std::string, uint32_t> ids;
+    std::shared_ptr<FunctionInstructions> decoded =
+        DecodeFunctionInstructions(*func, bv, true, [&](const std::string& name) {
+            auto [it, inserted] = ids.emplace(
+                name, static_cast<uint32_t>(names.size()));
+            if (inserted) names.push_back(name);
+            return it->second;
+        });
+    std::vector<uint64_t> dense(names.size());
+    for (const auto& [start, block] : decoded->blocks) {
+        for (uint32_t id : block.mnemonics) ++dense[id];
+    }
+    OpcodeCounts out;
+    for (size_t id = 0; id < dense.size(); ++id) {
+        if (dense[id]) out.emplace_back(names[id], dense[id]);
+    }
+    return out;
+}
+
+// BinaryView.project column store. Rows are filled on worker threads
+// (core calls only) and converted to Lua tables afterwards; booleans
+// are bytes so concurrent writes to neighbouring rows never share a
+// word.
+enum class ColumnKind { Integer, Boolean, String };
+
+struct ProjectColumn {
+    ColumnKind kind = ColumnKind::Integer;
+    std::vector<uint64_t> integers;
+    std::vector<uint8_t> booleans;
+    std::vector<std::string> strings;
+};
+
+template <typename T>
+struct ProjectField {
+    const char* name;
+    ColumnKind kind;
+    std::function<void(const T&, ProjectColumn&, size_t)> fill;
+};
+
+template <typename T, typename F>
+ProjectField<T> IntegerField(const char* name, F get) {
+    return {name, ColumnKind::Integer,
+            [get](const T& item, ProjectColumn& col, size_t row) {
+                col.integers[row] = static_cast<uint64_t>(get(item));
+            }};
+}
+
+template <typename T, typename F>
+ProjectField<T> BooleanField(const char* name, F get) {
+    return {name, ColumnKind::Boolean,
+            [get](const T& item, ProjectColumn& col, size_t row) {
+                col.booleans[row] = get(item) ? 1 : 0;
+            }};
+}
+
+template <typename T, typename F>
+ProjectField<T> StringField(const char* name, F get) {
+    return {name, ColumnKind::String,
+            [get](const T& item, ProjectColumn& col, size_t row) {
+                col.strings[row] = get(item);
+            }};
+}
+
+std::string FunctionName(const Ref<Function>& f) {
+    Ref<Symbol> sym = f->GetSymbol();
+    return sym ? sym->GetShortName() : "<unnamed>";
+}
+
+// Field names follow the per-object Lua properties; the short aliases
+// (start, end, block_count) are what reporting scripts tend to ask for.
+const std::vector<ProjectField<Ref<Function>>>& FunctionFields() {
+    using F = Ref<Function>;
+    static const std::vector<ProjectField<F>> fields = {
+        StringField<F>("name", FunctionName),
+        IntegerField<F>("start_addr", [](const F& f) { return f->GetStart(); }),
+        IntegerField<F>("start", [](const F& f) { return f->GetStart(); }),
+        IntegerField<F>("end_addr",
+                        [](const F& f) { return f->GetHighestAddress(); }),
+        IntegerField<F>("end",
+                        [](const F& f) { return f->GetHighestAddress(); }),
+        IntegerField<F>("size", [](const F& f) {
+            return f->GetHighestAddress() - f->GetStart();
+        }),
+        IntegerField<F>("block_count",
+                        [](const F& f) { return f->GetBasicBlocks().size(); }),
+        IntegerField<F>("total_blocks",
+                        [](const F& f) { return f->GetBasicBlocks().size(); }),
+        BooleanField<F>("is_thunk", [](const F& f) { return FunctionIsThunk(*f); }),
+        BooleanField<F>("is_exported",
+                        [](const F& f) { return IsExportedSymbol(f->GetSymbol()); }),
+        BooleanField<F>("can_return",
+                        [](const F& f) { return f->CanReturn().GetValue(); }),
+        BooleanField<F>("auto_discovered", [](const F& f) {
+            return f->WasAutomaticallyDiscovered();
+        }),
+        BooleanField<F>("has_user_annotations",
+                        [](const F& f) { return f->HasUserAnnotations(); }),
+        BooleanField<F>("has_unresolved_indirect_branches", [](const F& f) {
+            return f->HasUnresolvedIndirectBranches();
+        }),
+        BooleanField<F>("analysis_skipped",
+                        [](const F& f) { return f->IsAnalysisSkipped(); }),
+        BooleanField<F>("too_large",
+                        [](const F& f) { return f->IsFunctionTooLarge(); }),
+        BooleanField<F>("needs_update",
+                        [](const F& f) { return f->NeedsUpdate(); }),
+        StringField<F>("comment", [](const F& f) { return f->GetComment(); }),
+        StringField<F>("arch", [](const F& f) {
+            Ref<Architecture> arch = f->GetArchitecture();
+            return arch ? arch->GetName() : std::string();
+        }),
+        StringField<F>("platform", [](const F& f) {
+            Ref<Platform> platform = f->GetPlatform();
+            return platform ? platform->GetName() : std::string();
+        }),
+    };
+    return fields;
+}
+
+const std::vector<ProjectField<Ref<Symbol>>>& SymbolFields() {
+    using S = Ref<Symbol>;
+    static const std::vector<ProjectField<S>> fields = {
+        StringField<S>("name", [](const S& s) { return s->GetFullName(); }),
+        StringField<S>("short_name",
+                       [](const S& s) { return s->GetShortName(); }),
+        StringField<S>("raw_name", [](const S& s) { return s->GetRawName(); }),
+        IntegerField<S>("address", [](const S& s) { return s->GetAddress(); }),
+        StringField<S>("type",
+                       [](const S& s) { return EnumToString(s->GetType()); }),
+        StringField<S>("binding",
+                       [](const S& s) { return EnumToString(s->GetBinding()); }),
+        StringField<S>("namespace_name", [](const S& s) {
+            return s->GetNameSpace().GetString();
+        }),
+        IntegerField<S>("ordinal", [](const S& s) { return s->GetOrdinal(); }),
+        BooleanField<S>("auto_defined",
+                        [](const S& s) { return s->IsAutoDefined(); }),
+    };
+    return fields;
+}
+
+struct ProjectedDataVariable {
+    BinaryView* view;
+    DataVariable var;
+};
+
+const std::vector<ProjectField<ProjectedDataVariable>>& DataVariableFields() {
+    using D = ProjectedDataVariable;
+    static const std::vector<ProjectField<D>> fields = {
+        IntegerField<D>("address", [](const D& d) { return d.var.address; }),
+        StringField<D>("name", [](const D& d) {
+            Ref<Symbol> sym = d.view->GetSymbolByAddress(d.var.address);
+            return sym ? sym->GetShortName() : std::string();
+        }),
+        StringField<D>("type", [](const D& d) {
+            Ref<Type> type = d.var.type.GetValue();
+            return type ? type->GetString() : std::string("<unknown>");
+        }),
+        IntegerField<D>("size", [](const D& d) {
+            Ref<Type> type = d.var.type.GetValue();
+            return type ? type->GetWidth() : 0;
+        }),
+        IntegerField<D>("type_confidence",
+                        [](const D& d) { return d.var.type.GetConfidence(); }),
+        BooleanField<D>("auto_discovered",
+                        [](const D& d) { return d.var.autoDiscovered; }),
+    };
+    return fields;
+}
+
+const std::vector<ProjectField<Ref<Section>>>& SectionFields() {
+    using S = Ref<Section>;
+    static const std::vector<ProjectField<S>> fields = {
+        StringField<S>("name", [](const S& s) { return s->GetName(); }),
+        StringField<S>("type", [](const S& s) { return s->GetType(); }),
+        StringField<S>("semantics",
+                       [](const S& s) { return EnumToString(s->GetSemantics()); }),
+        IntegerField<S>("start_addr", [](const S& s) { return s->GetStart(); }),
+        IntegerField<S>("end_addr", [](const S& s) { return s->GetEnd(); }),
+        IntegerField<S>("length", [](const S& s) { return s->GetLength(); }),
+        IntegerField<S>("align", [](const S& s) { return s->GetAlignment(); }),
+        IntegerField<S>("entry_size",
+                        [](const S& s) { return s->GetEntrySize(); }),
+        StringField<S>("linked_section",
+                       [](const S& s) { return s->GetLinkedSection(); }),
+        StringField<S>("info_section",
+                       [](const S& s) { return s->GetInfoSection(); }),
+        BooleanField<S>("auto_defined",
+                        [](const S& s) { return s->AutoDefined(); }),
+    };
+    return fields;
+}
+
+const std::vector<ProjectField<Ref<BasicBlock>>>& BasicBlockFields() {
+    using B = Ref<BasicBlock>;
+    static const std::vector<ProjectField<B>> fields = {
+        IntegerField<B>("start_addr", [](const B& b) { return b->GetStart(); }),
+        IntegerField<B>("end_addr", [](const B& b) { return b->GetEnd(); }),
+        IntegerField<B>("length", [](const B& b) { return b->GetLength(); }),
+        IntegerField<B>("index", [](const B& b) { return b->GetIndex(); }),
+        IntegerField<B>("function", [](const B& b) {
+            Ref<Function> func = b->GetFunction();
+            return func ? func->GetStart() : 0;
+        }),
+        IntegerField<B>("outgoing_count",
+                        [](const B& b) { return b->GetOutgoingEdges().size(); }),
+        IntegerField<B>("incoming_count",
+                        [](const B& b) { return b->GetIncomingEdges().size(); }),
+        BooleanField<B>("can_exit", [](const B& b) { return b->CanExit(); }),
+        BooleanField<B>("has_undetermined_outgoing_edges", [](const B& b) {
+            return b->HasUndeterminedOutgoingEdges();
+        }),
+        BooleanField<B>("has_invalid_instructions",
+                        [](const B& b) { return b->HasInvalidInstructions(); }),
+    };
+    return fields;
+}
+
+// Resolve the requested field names, fill every column in one parallel
+// pass over the items and hand back {count = n, <field> = {...}, ...}.
+template <typename T>
+sol::table ProjectColumns(sol::state_view lua, const std::string& kind,
+                          const std::vector<T>& items,
+                          const std::vector<ProjectField<T>>& known,
+                          sol::table fields, size_t workers) {
+    std::vector<const ProjectField<T>*> selected;
+    for (size_t i = 1; i <= fields.size(); ++i) {
+        sol::optional<std::string> name = fields[i];
+        const auto match = std::find_if(
+            known.begin(), known.end(), [&](const ProjectField<T>& field) {
+                return name && *name == field.name;
+            });
+        if (match == known.end()) {
+            if (Ref<Logger> logger = GetLogger(lua)) {
+                logger->LogWarn("project: unknown %s field '%s'", kind.c_str(),
+                                name ? name->c_str() : "?");
+            }
+            continue;
+        }
+        selected.push_back(&*match);
+    }
+
+    std::vector<ProjectColumn> columns(selected.size());
+    for (size_t c = 0; c < selected.size(); ++c) {
+        ProjectColumn& col = columns[c];
+        col.kind = selected[c]->kind;
+        switch (col.kind) {
+        case ColumnKind::Integer: col.integers.resize(items.size()); break;
+        case ColumnKind::Boolean: col.booleans.resize(items.size()); break;
+        case ColumnKind::String: col.strings.resize(items.size()); break;
+        }
+    }
+    ParallelFor(items.size(), [&](size_t row) {
+        for (size_t c = 0; c < selected.size(); ++c) {
+            selected[c]->fill(items[row], columns[c], row);
+        }
+    }, workers);
+
+    const int n = static_cast<int>(items.size());
+    sol::table result =
+        lua.create_table(0, static_cast<int>(selected.size()) + 1);
+    result["count"] = items.size();
+    for (size_t c = 0; c < selected.size(); ++c) {
+        ProjectColumn& col = columns[c];
+        sol::table values = lua.create_table(n, 0);
+        for (int row = 0; row < n; ++row) {
+            switch (col.kind) {
+            case ColumnKind::Integer:
+                values[row + 1] = static_cast<lua_Integer>(col.integers[row]);
+                break;
+            case ColumnKind::Boolean:
+                values[row + 1] = col.booleans[row] != 0;
+                break;
+            case ColumnKind::String:
+                values[row + 1] = std::move(col.strings[row]);
+                break;
+            }
+        }
+        result[selected[c]->name] = values;
+    }
+    return result;
+}
+
+// Structural equality for summary fixpoints: tables compare by
+// contents (recursively, up to a nesting limit), everything else by
+// raw Lua equality.
+bool SummaryEqual(const sol::object& a, const sol::object& b, int depth = 0) {
+    if (a.get_type() != b.get_type()) return false;
+    if (a.get_type() != sol::type::table || depth > 32) return a == b;
+    sol::table ta = a.as<sol::table>();
+    sol::table tb = b.as<sol::table>();
+    size_t count = 0;
+    bool equal = true;
+    ta.for_each([&](const sol::object& key, const sol::object& value) {
+        ++count;
+        if (equal) equal = SummaryEqual(value, tb.raw_get<sol::object>(key),
+                                        depth + 1);
+    });
+    if (!equal) return false;
+    size_t other = 0;
+    tb.for_each([&](const sol::object&, const sol::object&) { ++other; });
+    return count == other;
+}
+
+// Copy of a summary kept for the next fixpoint comparison. Tables are
+// copied (values recursively, to the same nesting limit as
+// SummaryEqual) so a callback that updates and returns the table it
+// returned last round is still seen as changed.
+sol::object SummarySnapshot(sol::state_view lua, const sol::object& value,
+                            int depth = 0) {
+    if (value.get_type() != sol::type::table || depth > 32) return value;
+    sol::table copy = lua.create_table();
+    value.as<sol::table>().for_each(
+        [&](const sol::object& key, const sol::object& v) {
+            copy.raw_set(key, SummarySnapshot(lua, v, depth + 1));
+        });
+    return sol::make_object(lua, copy);
+}
+
+// Force the core to generate (and cache) the requested IL so the Lua
+// callback does not stall on it. Safe on worker threads.
+void PrefetchIL(const Ref<Function>& func, const std::string& level) {
+    if (level == "llil") {
+        func->GetLowLevelIL();
+    } else if (level == "mlil") {
+        func->GetMediumLevelIL();
+    } else if (level == "hlil") {
+        func->GetHighLevelIL();
+    }
+}
+
+// Function.calls / callers: one entry per call site, so the neighbour
+// of each edge is repeated sites[e] times.
+sol::table ExpandEdges(sol::state_view lua, const CallGraph& graph,
+                       const std::vector<uint32_t>& offsets,
+                       const std::vector<uint32_t>& adj,
+                       const std::vector<uint32_t>& sites,
+                       const std::vector<uint32_t>& totals, uint32_t node) {
+    sol::table result = lua.create_table(static_cast<int>(totals[node]), 0);
+    int idx = 1;
+    for (uint32_t e = offsets[node]; e < offsets[node + 1]; ++e) {
+        for (uint32_t k = 0; k < sites[e]; ++k) {
+            result[idx++] = graph.functions[adj[e]];
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+uint64_t ViewIndex::FunctionVersion(BNFunction* func) const {
+    std::lock_guard<std::mutex> lock(m_versionMutex);
+    auto it = m_functionVersions.find(func);
+    return it == m_functionVersions.end() ? 0 : it->second;
+}
+
+void ViewIndex::MarkFunctionChanged(BNFunction* func, bool removed) {
+    {
+        std::lock_guard<std::mutex> lock(m_versionMutex);
+        if (removed) {
+            m_functionVersions.erase(func);
+        } else {
+            m_functionVersions[func] = ++m_versionCounter;
+        }
+    }
+    m_functionsGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ViewIndex::MarkSymbolsChanged() {
+    {
+        std::lock_guard<std::mutex> lock(m_symbolMutex);
+        if (m_trackSymbols) {
+            m_symbolsResync = true;
+            m_symbolChanges.clear();
+        }
+    }
+    m_symbolsGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ViewIndex::QueueSymbolChange(Symbol* sym, bool added) {
+    {
+        std::lock_guard<std::mutex> lock(m_symbolMutex);
+        if (m_trackSymbols && !m_symbolsResync) {
+            if (m_symbolChanges.size() >= kMaxQueuedSymbolChanges) {
+                m_symbolsResync = true;
+                m_symbolChanges.clear();
+            } else {
+                m_symbolChanges.push_back({sym, added});
+            }
+        }
+    }
+    m_symbolsGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ViewIndex::BeginSymbolSnapshot() {
+    std::lock_guard<std::mutex> lock(m_symbolMutex);
+    m_trackSymbols = true;
+    m_symbolsResync = false;
+    m_symbolChanges.clear();
+}
+
+bool ViewIndex::TakeSymbolChanges(std::vector<SymbolChange>& out) {
+    std::lock_guard<std::mutex> lock(m_symbolMutex);
+    if (m_symbolsResync) return false;
+    out.swap(m_symbolChanges);
+    return true;
+}
+
+std::shared_ptr<ViewIndex> GetViewIndex(BinaryView& bv) {
+    std::call_once(s_finalizationHook, []() {
+        BinaryViewType::RegisterBinaryViewFinalizationEvent(
+            [](BinaryView* view) { DropViewIndex(view); });
+    });
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    RegistryEntry& entry = s_registry[bv.GetObject()];
+    if (!entry.index) {
+        entry.index = std::make_shared<ViewIndex>();
+        entry.notification =
+            std::make_unique<ViewIndexNotification>(entry.index.get());
+        bv.RegisterNotification(entry.notification.get());
+    }
+    return entry.index;
+}
+
+sol::table BinaryViewConstantUses(sol::this_state ts, BinaryView& bv,
+                                  sol::object value) {
+    sol::state_view lua(ts);
+    auto v = AsAddress(value);
+    if (!v) return lua.create_table();
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshConstantIndex(*index, bv);
+
+    const auto& merged = index->constants.merged;
+    auto range = std::equal_range(
+        merged.begin(), merged.end(), ConstantUse{*v, 0, 0},
+        [](const ConstantUse& a, const ConstantUse& b) {
+            return a.value < b.value;
+        });
+    return ConstantUsesToTable(lua, index->constants, range.first,
+                               range.second, false);
+}
+
+sol::table BinaryViewConstantsInRange(sol::this_state ts, BinaryView& bv,
+                                      sol::object lo, sol::object hi) {
+    sol::state_view lua(ts);
+    auto low = AsAddress(lo);
+    auto high = AsAddress(hi);
+    if (!low || !high || *low > *high) return lua.create_table();
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshConstantIndex(*index, bv);
+
+    // [lo, hi] is inclusive so the full 64-bit range is expressible.
+    const auto& merged = index->constants.merged;
+    auto first = std::lower_bound(
+        merged.begin(), merged.end(), *low,
+        [](const ConstantUse& a, uint64_t v) { return a.value < v; });
+    auto last = std::upper_bound(
+        first, merged.end(), *high,
+        [](uint64_t v, const ConstantUse& a) { return v < a.value; });
+    return ConstantUsesToTable(lua, index->constants, first, last, true);
+}
+
+sol::table BinaryViewFunctionsReferencingString(sol::this_state ts,
+                                                BinaryView& bv,
+                                                const std::string& pattern,
+                                                sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    sol::table result = lua.create_table();
+
+    // Plain substring match by default, mirroring
+    // get_functions_by_name(name, false). opts.exact compares the whole
+    // string; opts.regex treats pattern as an ECMAScript std::regex.
+    bool exact = false;
+    bool useRegex = false;
+    if (opts) {
+        exact = opts->get_or("exact", false);
+        useRegex = opts->get_or("regex", false);
+    }
+    std::regex re;
+    if (useRegex) {
+        try {
+            re = std::regex(pattern);
+        } catch (const std::regex_error& e) {
+            if (Ref<Logger> logger = GetLogger(lua)) {
+                logger->LogWarn("functions_referencing_string: bad regex: %s",
+                                e.what());
+            }
+            return result;
+        }
+    }
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshStringIndex(*index, bv);
+    const StringIndex& si = index->strings;
+
+    std::vector<bool> matched(si.strings.size(), false);
+    for (size_t i = 0; i < si.strings.size(); ++i) {
+        const std::string& v = si.strings[i].value;
+        if (useRegex) {
+            matched[i] = std::regex_search(v, re);
+        } else if (exact) {
+            matched[i] = (v == pattern);
+        } else {
+            matched[i] = (v.find(pattern) != std::string::npos);
+        }
+    }
+
+    int idx = 1;
+    auto it = si.refs.cbegin();
+    while (it != si.refs.cend()) {
+        const uint32_t fidx = it->func;
+        auto runEnd = it;
+        bool any = false;
+        while (runEnd != si.refs.cend() && runEnd->func == fidx) {
+            any = any || matched[runEnd->string];
+            ++runEnd;
+        }
+        if (any) {
+            sol::table entry = lua.create_table(0, 2);
+            entry["func"] = si.functions[fidx];
+            entry["strings"] =
+                FunctionStringsToTable(lua, si, it, runEnd, &matched);
+            result[idx++] = entry;
+        }
+        it = runEnd;
+    }
+    return result;
+}
+
+sol::table FunctionReferencedStrings(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    Ref<BinaryView> bv = func.GetView();
+    if (!bv) return lua.create_table();
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(*bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshStringIndex(*index, *bv);
+    const StringIndex& si = index->strings;
+
+    auto found = si.functionIndex.find(func.GetObject());
+    if (found == si.functionIndex.end()) return lua.create_table();
+    const uint32_t fidx = found->second;
+    auto range = std::equal_range(
+        si.refs.cbegin(), si.refs.cend(), StringReference{fidx, 0, 0},
+        [](const StringReference& a, const StringReference& b) {
+            return a.func < b.func;
+        });
+    return FunctionStringsToTable(lua, si, range.first, range.second,
+                                  nullptr);
+}
+
+
+std::vector<Ref<Function>> LookupFunctionNames(BinaryView& bv,
+                                               const NameQuery& query) {
+    std::regex re;
+    if (query.regex) {
+        auto flags = std::regex::ECMAScript;
+        if (query.ignoreCase) flags |= std::regex::icase;
+        re = std::regex(*query.regex, flags);
+    }
+    // With ignore_case every comparison runs on lower-cased text.
+    auto fold = [&](const std::optional<std::string>& s) {
+        return s && query.ignoreCase ? std::optional(ToLower(*s)) : s;
+    };
+    const std::optional<std::string> exact = fold(query.exact);
+    const std::optional<std::string> prefix = fold(query.prefix);
+    const std::optional<std::string> contains = fold(query.contains);
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshNameIndex(*index, bv);
+    const NameIndex& ni = index->names;
+
+    // Pick the narrowest index-backed criterion as the candidate
+    // source; every criterion is still verified per candidate.
+    std::optional<std::vector<uint32_t>> candidates;
+    if (exact) {
+        auto it = ni.exact.find(ToLower(*exact));
+        candidates.emplace();
+        if (it != ni.exact.end()) *candidates = it->second;
+    } else if (prefix) {
+        const std::string lower = ToLower(*prefix);
+        auto first = std::lower_bound(
+            ni.sorted.begin(), ni.sorted.end(), lower,
+            [&](uint32_t i, const std::string& p) { return ni.lowered[i] < p; });
+        candidates.emplace();
+        for (auto it = first; it != ni.sorted.end() &&
+                              ni.lowered[*it].compare(0, lower.size(), lower) == 0;
+             ++it) {
+            candidates->push_back(*it);
+        }
+        std::sort(candidates->begin(), candidates->end());
+    } else if (contains && contains->size() >= 3) {
+        candidates = TrigramCandidates(ni, ToLower(*contains));
+    } else if (query.regex) {
+        const std::string literal = ToLower(RequiredRegexLiteral(*query.regex));
+        if (literal.size() >= 3) candidates = TrigramCandidates(ni, literal);
+    }
+
+    auto matches = [&](uint32_t i) {
+        const std::string& name =
+            query.ignoreCase ? ni.lowered[i] : ni.names[i];
+        if (exact && name != *exact) return false;
+        if (prefix && name.compare(0, prefix->size(), *prefix) != 0) {
+            return false;
+        }
+        if (contains && name.find(*contains) == std::string::npos) {
+            return false;
+        }
+        if (query.regex && !std::regex_search(ni.names[i], re)) return false;
+        return true;
+    };
+
+    std::vector<Ref<Function>> result;
+    auto visit = [&](uint32_t i) {
+        if (!matches(i)) return true;
+        result.push_back(ni.functions[i]);
+        return query.limit == 0 || result.size() < query.limit;
+    };
+    if (candidates) {
+        for (uint32_t i : *candidates) {
+            if (!visit(i)) break;
+        }
+    } else {
+        for (uint32_t i = 0; i < ni.functions.size(); ++i) {
+            if (!visit(i)) break;
+        }
+    }
+    return result;
+}
+
+sol::table BinaryViewLookupFunctions(sol::this_state ts, BinaryView& bv,
+                                     sol::table query) {
+    sol::state_view lua(ts);
+    NameQuery q;
+    auto field = [&](const char* key) -> std::optional<std::string> {
+        sol::optional<std::string> v = query[key];
+        if (!v) return std::nullopt;
+        return *v;
+    };
+    q.exact = field("exact");
+    q.prefix = field("prefix");
+    q.contains = field("contains");
+    q.regex = field("regex");
+    q.ignoreCase = query.get_or("ignore_case", false);
+    q.limit = query.get_or<size_t>("limit", 0);
+
+    std::vector<Ref<Function>> funcs;
+    try {
+        funcs = LookupFunctionNames(bv, q);
+    } catch (const std::regex_error& e) {
+        if (Ref<Logger> logger = GetLogger(lua)) {
+            logger->LogWarn("lookup_functions: bad regex: %s", e.what());
+        }
+        return lua.create_table();
+    }
+    return ToLuaTable(ts, funcs);
+}
+
+sol::table BinaryViewImports(sol::this_state ts, BinaryView& bv) {
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshSymbolIndex(*index, bv);
+    return ToLuaTable(ts, MergedSymbols(index->symbols,
+                                        {ImportAddressSymbol,
+                                         ImportedFunctionSymbol,
+                                         ImportedDataSymbol}));
+}
+
+sol::table BinaryViewExports(sol::this_state ts, BinaryView& bv) {
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshSymbolIndex(*index, bv);
+    return ToLuaTable(ts, MergedSymbols(index->symbols,
+                                        {FunctionSymbol, DataSymbol}));
+}
+
+sol::table BinaryViewSymbolsOfType(sol::this_state ts, BinaryView& bv,
+                                   const std::string& type_name) {
+    return std::get<0>(BinaryViewSymbolsPage(
+        ts, bv, type_name, 0, std::numeric_limits<size_t>::max()));
+}
+
+std::tuple<sol::table, size_t> BinaryViewSymbolsPage(
+    sol::this_state ts, BinaryView& bv, const std::string& type_name,
+    size_t offset, size_t count) {
+    sol::state_view lua(ts);
+    auto type = EnumFromString<BNSymbolType>(type_name);
+    if (!type) return {lua.create_table(), 0};
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshSymbolIndex(*index, bv);
+
+    auto it = index->symbols.byType.find(*type);
+    if (it == index->symbols.byType.end()) return {lua.create_table(), 0};
+    const auto& part = it->second;
+    const size_t first = std::min(offset, part.size());
+    const size_t last = first + std::min(count, part.size() - first);
+    sol::table result = lua.create_table(static_cast<int>(last - first), 0);
+    int idx = 1;
+    for (size_t i = first; i < last; ++i) {
+        result[idx++] = part[i].symbol;
+    }
+    return {result, part.size()};
+}
+
+sol::table BinaryViewClassifyAddresses(sol::this_state ts, BinaryView& bv,
+                                       sol::table addrs,
+                                       sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    const bool withTags = opts && opts->get_or("tags", false);
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    RefreshAddressIndex(*index, bv, withTags);
+    const AddressIndex& ai = index->addresses;
+    Ref<BinaryView> bvRef = &bv;
+
+    const size_t count = addrs.size();
+    sol::table result = lua.create_table(static_cast<int>(count), 0);
+    for (size_t i = 1; i <= count; ++i) {
+        sol::table entry = lua.create_table(0, 6);
+        result[i] = entry;
+        sol::object value = addrs[i];
+        auto addr = AsAddress(value);
+        if (!addr) continue;
+        entry["address"] = HexAddress(*addr);
+
+        // Innermost (latest-starting) owner wins where intervals nest
+        // or overlap.
+        const BlockInterval* block = nullptr;
+        ai.blocks.Stab(*addr, [&](const BlockInterval& b) {
+            if (!block) block = &b;
+        });
+        if (block) {
+            entry["function"] = ai.blockSlices.functions[block->func];
+            entry["block"] = block->block;
+        }
+
+        const DataVariableInterval* var = nullptr;
+        ai.dataVariables.Stab(*addr, [&](const DataVariableInterval& v) {
+            if (!var) var = &v;
+        });
+        if (var) {
+            entry["data_var"] = DataVariableWrapper(
+                var->var.address, bvRef, var->var.type,
+                var->var.autoDiscovered);
+        }
+
+        const SectionInterval* section = nullptr;
+        ai.sections.Stab(*addr, [&](const SectionInterval& s) {
+            if (!section) section = &s;
+        });
+        if (section) entry["section"] = section->section;
+
+        if (withTags) {
+            auto it = std::lower_bound(
+                ai.tags.begin(), ai.tags.end(), *addr,
+                [](const TagReference& ref, uint64_t a) {
+                    return ref.addr < a;
+                });
+            sol::table tags = lua.create_table();
+            int t = 1;
+            for (; it != ai.tags.end() && it->addr == *addr; ++it) {
+                sol::table tag = lua.create_table(0, 3);
+                tag["addr"] = HexAddress(it->addr);
+                tag["tag"] = it->tag;
+                tag["auto"] = it->autoDefined;
+                tags[t++] = tag;
+            }
+            entry["tags"] = tags;
+        }
+    }
+    return result;
+}
+
+sol::table BinaryViewXrefsBatch(sol::this_state ts, BinaryView& bv,
+                                sol::table addrs,
+                                sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+
+    std::vector<XrefKind> kinds = {XrefKind::CodeRefs, XrefKind::DataRefs};
+    size_t workers = 0;
+    if (opts) {
+        if (sol::optional<sol::table> names = (*opts)["kinds"]) {
+            kinds.clear();
+            for (size_t i = 1; i <= names->size(); ++i) {
+                sol::optional<std::string> name = (*names)[i];
+                const auto* match = std::find_if(
+                    std::begin(kXrefKinds), std::end(kXrefKinds),
+                    [&](const auto& entry) {
+                        return name && *name == entry.first;
+                    });
+                if (match == std::end(kXrefKinds)) {
+                    if (Ref<Logger> logger = GetLogger(lua)) {
+                        logger->LogWarn("xrefs_batch: unknown kind '%s'",
+                                        name ? name->c_str() : "?");
+                    }
+                    continue;
+                }
+                kinds.push_back(match->second);
+            }
+        }
+        workers = opts->get_or<size_t>("workers", 0);
+    }
+    std::vector<uint64_t> queries;
+    queries.reserve(addrs.size());
+    for (size_t i = 1; i <= addrs.size(); ++i) {
+        sol::object value = addrs[i];
+        if (auto addr = AsAddress(value)) queries.push_back(*addr);
+    }
+
+    // Each (address, kind) pair is an independent core query; rows are
+    // stitched back together in input order afterwards.
+    std::vector<std::vector<XrefRow>> rows(queries.size());
+    ParallelFor(queries.size(), [&](size_t i) {
+        for (XrefKind kind : kinds) CollectXrefs(bv, queries[i], kind, rows[i]);
+    }, workers);
+
+    size_t total = 0;
+    for (const auto& r : rows) total += r.size();
+    const int n = static_cast<int>(total);
+    sol::table from = lua.create_table(n, 0);
+    sol::table to = lua.create_table(n, 0);
+    sol::table func = lua.create_table(n, 0);
+    sol::table kind = lua.create_table(n, 0);
+    sol::table functions = lua.create_table();
+    std::unordered_map<BNFunction*, int> functionIndex;
+    int idx = 1;
+    for (const auto& r : rows) {
+        for (const XrefRow& row : r) {
+            from[idx] = static_cast<lua_Integer>(row.from);
+            to[idx] = static_cast<lua_Integer>(row.to);
+            int f = 0;
+            if (row.func) {
+                auto [it, inserted] = functionIndex.emplace(
+                    row.func->GetObject(),
+                    static_cast<int>(functionIndex.size()) + 1);
+                if (inserted) functions[it->second] = row.func;
+                f = it->second;
+            }
+            func[idx] = f;
+            kind[idx] = XrefKindName(row.kind);
+            ++idx;
+        }
+    }
+
+    sol::table result = lua.create_table(0, 6);
+    result["count"] = total;
+    result["from"] = from;
+    result["to"] = to;
+    result["func"] = func;
+    result["kind"] = kind;
+    result["functions"] = functions;
+    return result;
+}
+
+const CallGraphComponents& CallGraph::Components() const {
+    std::call_once(m_componentsOnce,
+                   [this]() { m_components = ComputeComponents(*this); });
+    return *m_components;
+}
+
+std::shared_ptr<CallGraph> GetCallGraph(BinaryView& bv) {
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    CallGraphIndex& cg = index->callGraph;
+    if (cg.slices.Refresh(*index, bv, ScanFunctionCalls) || !cg.graph) {
+        cg.graph = BuildCallGraph(cg.slices);
+    }
+    return cg.graph;
+}
+
+sol::table FunctionCalls(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    Ref<BinaryView> view = func.GetView();
+    if (!view) return lua.create_table();
+    std::shared_ptr<CallGraph> graph = GetCallGraph(*view);
+    auto node = graph->IndexOf(func.GetObject());
+    if (!node) return lua.create_table();
+    return ExpandEdges(lua, *graph, graph->calleeOffsets, graph->callees,
+                       graph->calleeSites, graph->outSites, *node);
+}
+
+sol::table FunctionCallers(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    Ref<BinaryView> view = func.GetView();
+    if (!view) return lua.create_table();
+    std::shared_ptr<CallGraph> graph = GetCallGraph(*view);
+    auto node = graph->IndexOf(func.GetObject());
+    if (!node) return lua.create_table();
+    return ExpandEdges(lua, *graph, graph->callerOffsets, graph->callers,
+                       graph->callerSites, graph->inSites, *node);
+}
+
+sol::table FunctionCallees(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    Ref<BinaryView> view = func.GetView();
+    if (!view) return lua.create_table();
+    std::shared_ptr<CallGraph> graph = GetCallGraph(*view);
+    auto node = graph->IndexOf(func.GetObject());
+    if (!node) return lua.create_table();
+    const uint32_t first = graph->calleeOffsets[*node];
+    const uint32_t last = graph->calleeOffsets[*node + 1];
+    sol::table result = lua.create_table(static_cast<int>(last - first), 0);
+    for (uint32_t e = first; e < last; ++e) {
+        result[e - first + 1] = graph->functions[graph->callees[e]];
+    }
+    return result;
+}
+
+sol::table FunctionCalleeAddresses(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    Ref<BinaryView> view = func.GetView();
+    if (!view) return lua.create_table();
+    std::shared_ptr<CallGraph> graph = GetCallGraph(*view);
+    auto node = graph->IndexOf(func.GetObject());
+    if (!node) return lua.create_table();
+    const uint32_t first = graph->targetOffsets[*node];
+    const uint32_t last = graph->targetOffsets[*node + 1];
+    sol::table result = lua.create_table(static_cast<int>(last - first), 0);
+    for (uint32_t t = first; t < last; ++t) {
+        result[t - first + 1] = HexAddress(graph->targets[t]);
+    }
+    return result;
+}
+
+void RegisterAnalysisIndexBindings(sol::state_view lua, Ref<Logger> logger) {
+    if (logger) logger->LogDebug("Registering analysis index bindings");
+
+    // Node arguments and results are 1-based function indices; 0 or
+    // out-of-range indices yield nil / empty results.
+    auto node = [](const CallGraph& g, size_t i) -> std::optional<uint32_t> {
+        if (i == 0 || i > g.NodeCount()) return std::nullopt;
+        return static_cast<uint32_t>(i - 1);
+    };
+    auto neighbours = [node](sol::this_state ts, const CallGraph& g, size_t i,
+                             const std::vector<uint32_t>& offsets,
+                             const std::vector<uint32_t>& adj) -> sol::table {
+        sol::state_view lua(ts);
+        auto n = node(g, i);
+        if (!n) return lua.create_table();
+        const uint32_t first = offsets[*n];
+        const uint32_t last = offsets[*n + 1];
+        sol::table result = lua.create_table(static_cast<int>(last - first), 0);
+        for (uint32_t e = first; e < last; ++e) {
+            result[e - first + 1] = adj[e] + 1;
+        }
+        return result;
+    };
+
+    lua.new_usertype<CallGraph>(CALLGRAPH_METATABLE,
+        sol::no_constructor,
+
+        "node_count", sol::property(&CallGraph::NodeCount),
+        "edge_count", sol::property(&CallGraph::EdgeCount),
+
+        "functions", [](sol::this_state ts, const CallGraph& g) -> sol::table {
+            return ToLuaTable(ts, g.functions);
+        },
+
+        "function_at", [node](const CallGraph& g, size_t i) -> Ref<Function> {
+            auto n = node(g, i);
+            return n ? g.functions[*n] : nullptr;
+        },
+
+        "index_of", [](const CallGraph& g, Function& func)
+            -> std::optional<size_t> {
+            auto n = g.IndexOf(func.GetObject());
+            if (!n) return std::nullopt;
+            return *n + 1;
+        },
+
+        "callees", [neighbours](sol::this_state ts, const CallGraph& g,
+                                size_t i) -> sol::table {
+            return neighbours(ts, g, i, g.calleeOffsets, g.callees);
+        },
+
+        "callers", [neighbours](sol::this_state ts, const CallGraph& g,
+                                size_t i) -> sol::table {
+            return neighbours(ts, g, i, g.callerOffsets, g.callers);
+        },
+
+        // Distinct neighbours.
+        "out_degree", [node](const CallGraph& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.calleeOffsets[*n + 1] - g.calleeOffsets[*n] : 0;
+        },
+
+        "in_degree", [node](const CallGraph& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.callerOffsets[*n + 1] - g.callerOffsets[*n] : 0;
+        },
+
+        // Call sites, counting repeated calls to the same function
+        // (#func:calls() / #func:callers()).
+        "out_sites", [node](const CallGraph& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.outSites[*n] : 0;
+        },
+
+        "in_sites", [node](const CallGraph& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.inSites[*n] : 0;
+        },
+
+        // Algorithms. Component ids are 1-based and ascend bottom-up
+        // (a callee's component id is never above its caller's).
+        "scc_ids", [](sol::this_state ts, const CallGraph& g) -> sol::table {
+            return ToLuaTable(ts, g.Components().id,
+                              [](uint32_t c) { return c + 1; });
+        },
+
+        "sccs", [](sol::this_state ts, const CallGraph& g,
+                   sol::optional<size_t> min_size) -> sol::table {
+            sol::state_view lua(ts);
+            const CallGraphComponents& comps = g.Components();
+            const size_t minSize = min_size.value_or(1);
+            sol::table result = lua.create_table();
+            int idx = 1;
+            for (size_t c = 0; c < comps.Count(); ++c) {
+                const uint32_t first = comps.offsets[c];
+                const uint32_t last = comps.offsets[c + 1];
+                if (last - first < minSize) continue;
+                sol::table members =
+                    lua.create_table(static_cast<int>(last - first), 0);
+                for (uint32_t k = first; k < last; ++k) {
+                    members[k - first + 1] = comps.nodes[k] + 1;
+                }
+                result[idx++] = members;
+            }
+            return result;
+        },
+
+        // In a recursion group: mutual recursion or a direct self-call.
+        "is_recursive", [node](const CallGraph& g, size_t i) -> bool {
+            auto n = node(g, i);
+            if (!n) return false;
+            const CallGraphComponents& comps = g.Components();
+            return comps.recursive[comps.id[*n]] != 0;
+        },
+
+        // {component = node -> component id, from = {...}, to = {...}}:
+        // the DAG of components with caller -> callee edges as columns.
+        "condensation", [](sol::this_state ts, const CallGraph& g)
+            -> sol::table {
+            sol::state_view lua(ts);
+            const CallGraphComponents& comps = g.Components();
+            const int edges = static_cast<int>(comps.dag.size());
+            sol::table from = lua.create_table(edges, 0);
+            sol::table to = lua.create_table(edges, 0);
+            int idx = 1;
+            for (size_t c = 0; c < comps.Count(); ++c) {
+                for (uint32_t e = comps.dagOffsets[c];
+                     e < comps.dagOffsets[c + 1]; ++e) {
+                    from[idx] = c + 1;
+                    to[idx] = comps.dag[e] + 1;
+                    ++idx;
+                }
+            }
+            sol::table result = lua.create_table(0, 4);
+            result["count"] = comps.Count();
+            result["component"] = ToLuaTable(
+                ts, comps.id, [](uint32_t c) { return c + 1; });
+            result["from"] = from;
+            result["to"] = to;
+            return result;
+        },
+
+        "topological_order", [](sol::this_state ts, const CallGraph& g,
+                                sol::optional<bool> bottom_up) -> sol::table {
+            return ToLuaTable(ts, TopologicalOrder(g, bottom_up.value_or(false)),
+                              [](uint32_t v) { return v + 1; });
+        },
+
+        // {shortest = {...}, longest = {...}} per node, -1 if unreached.
+        "depths", [node](sol::this_state ts, const CallGraph& g,
+                         sol::optional<sol::table> roots) -> sol::table {
+            sol::state_view lua(ts);
+            std::vector<uint32_t> seeds;
+            if (roots) {
+                for (size_t k = 1; k <= roots->size(); ++k) {
+                    sol::optional<size_t> i = (*roots)[k];
+                    if (auto n = i ? node(g, *i) : std::nullopt) {
+                        seeds.push_back(*n);
+                    }
+                }
+                if (seeds.empty()) return lua.create_table();
+            }
+            std::vector<int64_t> shortest, longest;
+            CallDepths(g, std::move(seeds), shortest, longest);
+            sol::table result = lua.create_table(0, 2);
+            result["shortest"] = ToLuaTable(ts, shortest);
+            result["longest"] = ToLuaTable(ts, longest);
+            return result;
+        },
+
+        // Longest call chain below node i, recursion groups collapsed.
+        "call_depth", [node](const CallGraph& g, size_t i)
+            -> std::optional<size_t> {
+            auto n = node(g, i);
+            if (!n) return std::nullopt;
+            const CallGraphComponents& comps = g.Components();
+            return comps.height[comps.id[*n]];
+        },
+
+        "reachable", [node](sol::this_state ts, const CallGraph& g, size_t i,
+                            sol::optional<sol::table> opts) -> sol::table {
+            auto n = node(g, i);
+            if (!n) return sol::state_view(ts).create_table();
+            bool reverse = false;
+            size_t maxDepth = 0;
+            if (opts) {
+                reverse = opts->get_or("reverse", false);
+                maxDepth = opts->get_or<size_t>("max_depth", 0);
+            }
+            return ToLuaTable(ts, Reachable(g, *n, reverse, maxDepth),
+                              [](uint32_t v) { return v + 1; });
+        },
+
+        "paths", [node](sol::this_state ts, const CallGraph& g, size_t from,
+                        size_t to, sol::optional<sol::table> opts)
+            -> sol::table {
+            sol::state_view lua(ts);
+            auto src = node(g, from);
+            auto dst = node(g, to);
+            if (!src || !dst) return lua.create_table();
+            size_t maxLength = 8;
+            size_t maxPaths = 256;
+            if (opts) {
+                maxLength = opts->get_or<size_t>("max_length", maxLength);
+                maxPaths = opts->get_or<size_t>("max_paths", maxPaths);
+            }
+            auto paths = SimplePaths(g, *src, *dst, maxLength, maxPaths);
+            sol::table result = lua.create_table(static_cast<int>(paths.size()), 0);
+            for (size_t p = 0; p < paths.size(); ++p) {
+                result[p + 1] = ToLuaTable(ts, paths[p],
+                                           [](uint32_t v) { return v + 1; });
+            }
+            return result;
+        }
+    );
+
+    if (logger) logger->LogDebug("Analysis index bindings registered");
+}
+
+sol::table BinaryViewSummarizeBottomUp(sol::this_state ts, BinaryView& bv,
+                                       sol::function callback,
+                                       sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    std::string prefetch;
+    std::optional<std::string> metadataKey;
+    size_t maxIterations = 8;
+    size_t workers = 0;
+    if (opts) {
+        prefetch = opts->get_or<std::string>("prefetch", "");
+        if (sol::optional<std::string> key = (*opts)["metadata_key"]) {
+            metadataKey = *key;
+        }
+        maxIterations = std::max<size_t>(
+            1, opts->get_or<size_t>("max_iterations", maxIterations));
+        workers = opts->get_or<size_t>("workers", 0);
+    }
+
+    std::shared_ptr<CallGraph> graph = GetCallGraph(bv);
+    const CallGraphComponents& comps = graph->Components();
+
+    // Components of equal height have no call path between them, so
+    // each height is one wave; every callee component sits in an
+    // earlier wave.
+    std::vector<std::vector<uint32_t>> waves;
+    for (uint32_t c = 0; c < comps.Count(); ++c) {
+        const uint32_t h = comps.height[c];
+        if (waves.size() <= h) waves.resize(h + 1);
+        waves[h].push_back(c);
+    }
+
+    Ref<Logger> logger = GetLogger(lua);
+    std::vector<sol::object> summaries(graph->NodeCount(), sol::lua_nil);
+    // Last round's summary of each recursive-group member, by value.
+    std::vector<sol::object> previous(graph->NodeCount(), sol::lua_nil);
+    sol::table result = lua.create_table(static_cast<int>(graph->NodeCount()), 0);
+    int idx = 1;
+
+    auto summarize = [&](uint32_t v) -> sol::object {
+        const uint32_t first = graph->calleeOffsets[v];
+        const uint32_t last = graph->calleeOffsets[v + 1];
+        sol::table callees = lua.create_table(static_cast<int>(last - first), 0);
+        for (uint32_t e = first; e < last; ++e) {
+            sol::table entry = lua.create_table(0, 2);
+            entry["func"] = graph->functions[graph->callees[e]];
+            entry["summary"] = summaries[graph->callees[e]];
+            callees[e - first + 1] = entry;
+        }
+        sol::protected_function_result rv =
+            callback(graph->functions[v], callees);
+        if (!rv.valid()) {
+            sol::error err = rv;
+            if (logger) {
+                logger->LogWarn("summarize_bottom_up: %s: %s",
+                                graph->functions[v]->GetSymbol()
+                                    ->GetShortName().c_str(),
+                                err.what());
+            }
+            return sol::make_object(lua, sol::lua_nil);
+        }
+        return rv.get<sol::object>();
+    };
+
+    for (const auto& wave : waves) {
+        if (!prefetch.empty()) {
+            std::vector<uint32_t> nodes;
+            for (uint32_t c : wave) {
+                nodes.insert(nodes.end(),
+                             comps.nodes.begin() + comps.offsets[c],
+                             comps.nodes.begin() + comps.offsets[c + 1]);
+            }
+            ParallelFor(nodes.size(), [&](size_t k) {
+                PrefetchIL(graph->functions[nodes[k]], prefetch);
+            }, workers);
+        }
+
+        for (uint32_t c : wave) {
+            // Recursion groups are re-run until no member's summary
+            // changes (or the iteration cap is hit); everything else
+            // runs once.
+            size_t iteration = 0;
+            bool changed = true;
+            while (changed && iteration < maxIterations) {
+                changed = false;
+                for (uint32_t k = comps.offsets[c]; k < comps.offsets[c + 1];
+                     ++k) {
+                    const uint32_t v = comps.nodes[k];
+                    sol::object next = summarize(v);
+                    if (!SummaryEqual(next, previous[v])) changed = true;
+                    if (comps.recursive[c]) {
+                        previous[v] = SummarySnapshot(lua, next);
+                    }
+                    summaries[v] = std::move(next);
+                }
+                ++iteration;
+                if (!comps.recursive[c]) break;
+            }
+
+            for (uint32_t k = comps.offsets[c]; k < comps.offsets[c + 1];
+                 ++k) {
+                const uint32_t v = comps.nodes[k];
+                sol::table entry = lua.create_table(0, 2);
+                entry["func"] = graph->functions[v];
+                entry["summary"] = summaries[v];
+                result[idx++] = entry;
+
+                if (!metadataKey ||
+                    summaries[v].get_type() == sol::type::lua_nil) {
+                    continue;
+                }
+                if (BNMetadata* md = MetadataFromLua(summaries[v])) {
+                    BNFunctionStoreMetadata(graph->functions[v]->GetObject(),
+                                            metadataKey->c_str(), md, false);
+                    BNFreeMetadata(md);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool FunctionIsThunk(Function& func) {
+    Ref<LowLevelILFunction> llil = func.GetLowLevelIL();
+    if (!llil) return false;
+    auto blocks = llil->GetBasicBlocks();
+    if (blocks.size() != 1) return false;
+    // Check if the single block ends with a tailcall
+    Ref<BasicBlock> block = blocks[0];
+    size_t startIdx = block->GetStart();
+    size_t endIdx = block->GetEnd();
+    if (endIdx <= startIdx) return false;
+    BNLowLevelILInstruction instr =
+        BNGetLowLevelILByIndex(llil->GetObject(), endIdx - 1);
+    return instr.operation == LLIL_TAILCALL ||
+           instr.operation == LLIL_TAILCALL_SSA;
+}
+
+sol::table BinaryViewProject(sol::this_state ts, BinaryView& bv,
+                             const std::string& kind, sol::table fields,
+                             sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    const size_t workers = opts ? opts->get_or<size_t>("workers", 0) : 0;
+
+    if (kind == "functions") {
+        return ProjectColumns(lua, kind, bv.GetAnalysisFunctionList(),
+                              FunctionFields(), fields, workers);
+    }
+    if (kind == "symbols") {
+        return ProjectColumns(lua, kind, bv.GetSymbols(), SymbolFields(),
+                              fields, workers);
+    }
+    if (kind == "data_vars") {
+        std::vector<ProjectedDataVariable> vars;
+        for (const auto& [addr, var] : bv.GetDataVariables()) {
+            vars.push_back({&bv, var});
+        }
+        return ProjectColumns(lua, kind, vars, DataVariableFields(), fields,
+                              workers);
+    }
+    if (kind == "sections") {
+        return ProjectColumns(lua, kind, bv.GetSections(), SectionFields(),
+                              fields, workers);
+    }
+    if (kind == "basic_blocks") {
+        // Block lists are fetched per function on the pool, then
+        // flattened in function start order.
+        std::vector<Ref<Function>> funcs = bv.GetAnalysisFunctionList();
+        std::vector<std::vector<Ref<BasicBlock>>> perFunction(funcs.size());
+        ParallelFor(funcs.size(), [&](size_t i) {
+            perFunction[i] = funcs[i]->GetBasicBlocks();
+        }, workers);
+        std::vector<Ref<BasicBlock>> blocks;
+        for (auto& list : perFunction) {
+            blocks.insert(blocks.end(), std::make_move_iterator(list.begin()),
+                          std::make_move_iterator(list.end()));
+        }
+        return ProjectColumns(lua, kind, blocks, BasicBlockFields(), fields,
+                              workers);
+    }
+
+    if (Ref<Logger> logger = GetLogger(lua)) {
+        logger->LogWarn("project: unknown kind '%s'", kind.c_str());
+    }
+    sol::table result = lua.create_table(0, 1);
+    result["count"] = 0;
+    return result;
+}
+
+std::vector<FunctionSummary> GetFunctionSummaries(
+    BinaryView& bv, const std::vector<Ref<Function>>& funcs) {
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    FunctionSummaryCache& cache = index->summaries;
+    const uint64_t symbolsGeneration = index->SymbolsGeneration();
+
+    std::vector<uint64_t> versions(funcs.size());
+    std::vector<size_t> stale;
+    for (size_t i = 0; i < funcs.size(); ++i) {
+        BNFunction* key = funcs[i]->GetObject();
+        versions[i] = index->FunctionVersion(key);
+        auto it = cache.entries.find(key);
+        if (it == cache.entries.end() || it->second.version != versions[i]) {
+            stale.push_back(i);
+        } else if (it->second.symbolsGeneration != symbolsGeneration) {
+            it->second.summary.isExported =
+                IsExportedSymbol(funcs[i]->GetSymbol());
+            it->second.symbolsGeneration = symbolsGeneration;
+        }
+    }
+
+    std::vector<FunctionSummary> built(stale.size());
+    ParallelFor(stale.size(), [&](size_t k) {
+        built[k] = ComputeFunctionSummary(*funcs[stale[k]]);
+    });
+    for (size_t k = 0; k < stale.size(); ++k) {
+        const Ref<Function>& func = funcs[stale[k]];
+        FunctionSummaryCache::Entry& entry = cache.entries[func->GetObject()];
+        entry.func = func;
+        entry.version = versions[stale[k]];
+        entry.symbolsGeneration = symbolsGeneration;
+        entry.summary = built[k];
+    }
+
+    std::vector<FunctionSummary> out;
+    out.reserve(funcs.size());
+    for (const Ref<Function>& func : funcs) {
+        out.push_back(cache.entries[func->GetObject()].summary);
+    }
+
+    PruneRemovedFunctions(cache.entries, cache.liveCount, bv);
+    return out;
+}
+
+FunctionSummary GetFunctionSummary(Function& func) {
+    Ref<BinaryView> view = func.GetView();
+    if (!view) return ComputeFunctionSummary(func);
+    return GetFunctionSummaries(*view, {Ref<Function>(&func)}).front();
+}
+
+sol::table FunctionSummaryTable(sol::this_state ts, Function& func) {
+    return SummaryToTable(sol::state_view(ts), GetFunctionSummary(func));
+}
+
+sol::table BinaryViewFunctionSummaries(sol::this_state ts, BinaryView& bv,
+                                       sol::optional<sol::table> funcs) {
+    sol::state_view lua(ts);
+    std::vector<Ref<Function>> list;
+    // Input positions that hold a Function; everything else maps to
+    // false in the result so it stays aligned with the input array.
+    std::vector<size_t> positions;
+    size_t count = 0;
+    if (funcs) {
+        count = funcs->size();
+        for (size_t i = 1; i <= count; ++i) {
+            sol::object value = (*funcs)[i];
+            if (!value.is<Function>()) continue;
+            list.push_back(Ref<Function>(&value.as<Function&>()));
+            positions.push_back(i);
+        }
+    } else {
+        list = bv.GetAnalysisFunctionList();
+        count = list.size();
+        for (size_t i = 1; i <= count; ++i) positions.push_back(i);
+    }
+
+    std::vector<FunctionSummary> summaries = GetFunctionSummaries(bv, list);
+    sol::table result = lua.create_table(static_cast<int>(count), 0);
+    for (size_t i = 1; i <= count; ++i) result[i] = false;
+    for (size_t k = 0; k < summaries.size(); ++k) {
+        sol::table entry = SummaryToTable(lua, summaries[k]);
+        entry["func"] = list[k];
+        result[positions[k]] = entry;
+    }
+    return result;
+}
+
+std::shared_ptr<const BlockInstructions> GetBlockInstructions(
+    BasicBlock& block, bool mnemonics) {
+    Ref<Function> func = block.GetFunction();
+    if (!func) return nullptr;
+    Ref<BinaryView> view = func->GetView();
+    if (!view) return nullptr;
+
+    std::shared_ptr<ViewIndex> index = GetViewIndex(*view);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    InstructionCache& cache = index->instructions;
+    BNFunction* key = func->GetObject();
+    const uint64_t version = index->FunctionVersion(key);
+    auto it = cache.entries.find(key);
+    if (it == cache.entries.end() ||
+        it->second.instructions->version != version ||
+        (mnemonics && !it->second.instructions->hasMnemonics)) {
+        std::shared_ptr<FunctionInstructions> decoded =
+            DecodeFunctionInstructions(*func, *view, mnemonics,
+                [&](const std::string& name) {
+                    return InternMnemonic(cache, name);
+                });
+        decoded->version = version;
+        InstructionCache::Entry& entry = cache.entries[key];
+        entry.func = func;
+        entry.instructions = std::move(decoded);
+        PruneRemovedFunctions(cache.entries, cache.liveCount, *view);
+        it = cache.entries.find(key);
+    }
+
+    std::shared_ptr<const FunctionInstructions> owner = it->second.instructions;
+    auto found = owner->blocks.find(block.GetStart());
+    if (found == owner->blocks.end()) return nullptr;
+    return std::shared_ptr<const BlockInstructions>(owner, &found->second);
+}
+
+sol::table BasicBlockInstructionArrays(sol::this_state ts, BasicBlock& block) {
+    sol::state_view lua(ts);
+    std::shared_ptr<const BlockInstructions> insns =
+        GetBlockInstructions(block, true);
+    sol::table result = lua.create_table(0, 5);
+    if (!insns) {
+        result["count"] = 0;
+        return result;
+    }
+
+    const int n = static_cast<int>(insns->addresses.size());
+    sol::table address = lua.create_table(n, 0);
+    sol::table length = lua.create_table(n, 0);
+    sol::table mnemonic = lua.create_table(n, 0);
+    for (int i = 0; i < n; ++i) {
+        address[i + 1] = static_cast<lua_Integer>(insns->addresses[i]);
+        length[i + 1] = insns->lengths[i];
+        mnemonic[i + 1] = insns->mnemonics[i];
+    }
+
+    // Names for the ids used by this block; ids are stable for the
+    // lifetime of the view.
+    sol::table names = lua.create_table();
+    {
+        Ref<BinaryView> view = block.GetFunction()->GetView();
+        std::shared_ptr<ViewIndex> index = GetViewIndex(*view);
+        std::lock_guard<std::mutex> lock(index->Mutex());
+        const std::vector<std::string>& known = index->instructions.mnemonicNames;
+        for (uint32_t id : insns->mnemonics) {
+            if (id < known.size()) names[id] = known[id];
+        }
+    }
+
+    result["count"] = n;
+    result["address"] = address;
+    result["length"] = length;
+    result["mnemonic"] = mnemonic;
+    result["mnemonics"] = names;
+    return result;
+}
+
+sol::table BinaryViewOpcodeHistogram(sol::this_state ts, BinaryView& bv,
+                                     sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    std::string level = "disasm";
+    bool perFunction = true;
+    bool nested = true;
+    size_t workers = 0;
+    if (opts) {
+        level = opts->get_or<std::string>("level", level);
+        perFunction = opts->get_or("per_function", perFunction);
+        nested = opts->get_or("nested", nested);
+        workers = opts->get_or<size_t>("workers", 0);
+    }
+
+    sol::table result = lua.create_table(0, 5);
+    if (level != "disasm" && level != "llil" && level != "mlil" &&
+        level != "hlil") {
+        if (Ref<Logger> logger = GetLogger(lua)) {
+            logger->LogWarn("opcode_histogram: unknown level '%s'",
+                            level.c_str());
+        }
+        result["count"] = 0;
+        result["totals"] = lua.create_table();
+        return result;
+    }
+
+    std::vector<Ref<Function>> funcs = bv.GetAnalysisFunctionList();
+    std::vector<OpcodeCounts> counts(funcs.size());
+    ParallelFor(funcs.size(), [&](size_t i) {
+        counts[i] = CountFunctionOpcodes(funcs[i], bv, level, nested);
+    }, workers);
+
+    std::map<std::string, uint64_t> totals;
+    const int n = static_cast<int>(funcs.size());
+    sol::table func = lua.create_table(perFunction ? n : 0, 0);
+    sol::table start = lua.create_table(perFunction ? n : 0, 0);
+    sol::table perFunctionCounts = lua.create_table(perFunction ? n : 0, 0);
+    for (int i = 0; i < n; ++i) {
+        sol::table row;
+        if (perFunction) {
+            row = lua.create_table(0, static_cast<int>(counts[i].size()));
+        }
+        for (const auto& [name, count] : counts[i]) {
+            totals[name] += count;
+            if (perFunction) row[name] = count;
+        }
+        if (perFunction) {
+            func[i + 1] = funcs[i];
+            start[i + 1] = static_cast<lua_Integer>(funcs[i]->GetStart());
+            perFunctionCounts[i + 1] = row;
+        }
+    }
+
+    sol::table totalsTable = lua.create_table(0, static_cast<int>(totals.size()));
+    for (const auto& [name, count] : totals) totalsTable[name] = count;
+
+    result["count"] = perFunction ? n : 0;
+    if (perFunction) {
+        result["func"] = func;
+        result["start"] = start;
+        result["counts"] = perFunctionCounts;
+    }
+    result["totals"] = totalsTable;
+    return result;
+}
+
+}  // namespace BinjaLua
@@ -0,0 +1,634 @@
+// Native per-BinaryView analysis indexes for binja-lua.
+//
+// Whole-binary queries (constant uses, ...) are answered from a
+// ViewIndex owned by the plugin, one per BinaryView. Each index is
+// built lazily on first query and kept current through a
+// BinaryDataNotification registered on the view. Notification
+// callbacks run on core analysis threads, so they only bump counters;
+// the actual rebuild happens on the querying (Lua) thread the next
+// time a stale index is read. The ViewIndex is dropped when the view
+// is finalized.
+//
+// Rebuilds fan out over functions with ParallelFor. Worker bodies
+// must not touch the Lua state - sol2 objects are only created after
+// the workers have joined.
+
+#pragma once
+
+#include "cfg.h"
+#include "common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace BinjaLua {
+
+// Run body(i) for every i in [0, count) on up to max_workers threads
+// (0 = std::thread::hardware_concurrency()). Small inputs run inline on
+// the calling thread. The first exception thrown by any body is
+// rethrown on the calling thread after every worker has joined, so a
+// failing BN call surfaces as a Lua error instead of std::terminate.
+template <typename F>
+void ParallelFor(size_t count, F&& body, size_t max_workers = 0) {
+    size_t workers = max_workers;
+    if (workers == 0) {
+        workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers = std::min(workers, count);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+        pool.emplace_back([&]() {
+            for (size_t i = next.fetch_add(1); i < count;
+                 i = next.fetch_add(1)) {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    if (!failure) failure = std::current_exception();
+                }
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+class ViewIndex;
+
+// Per-function slice cache shared by the function-granular indexes.
+// Each analysis function owns one Slice; Refresh() rebuilds only the
+// slices whose function was added or updated since the last refresh
+// (in parallel) and drops slices of removed functions. Entries hold a
+// Ref<Function> so the BNFunction* key cannot be recycled while the
+// slice is alive.
+template <typename Slice>
+struct FunctionSliceCache {
+    struct Entry {
+        Ref<Function> func;
+        uint64_t version = 0;
+        Slice slice;
+    };
+
+    static constexpr uint64_t kNeverBuilt = ~0ULL;
+
+    uint64_t generation = kNeverBuilt;
+    // Current analysis function list in GetAnalysisFunctionList order.
+    // Merged indexes refer to functions by position in this vector.
+    std::vector<Ref<Function>> functions;
+    std::unordered_map<BNFunction*, Entry> entries;
+
+    // Returns true when any slice was rebuilt or dropped, i.e. when
+    // merged data derived from the slices has to be regenerated.
+    template <typename Build>
+    bool Refresh(ViewIndex& index, BinaryView& bv, Build&& build);
+
+    const Slice* Find(BNFunction* func) const {
+        auto it = entries.find(func);
+        return it == entries.end() ? nullptr : &it->second.slice;
+    }
+};
+
+// Constant-use index (bv:constant_uses / bv:constants_in_range).
+// Values are the LLIL CONST / CONST_PTR / EXTERN_PTR immediates,
+// truncated to the expression width so a 32-bit 0xedb88320 is found
+// regardless of how the lifter sign-extended it.
+struct ConstantUse {
+    uint64_t value;
+    uint64_t address;
+    uint32_t func;  // index into FunctionSliceCache::functions
+};
+
+struct ConstantIndex {
+    FunctionSliceCache<std::vector<ConstantUse>> slices;
+    // All uses sorted by (value, address).
+    std::vector<ConstantUse> merged;
+};
+
+// String cross-reference index (bv:functions_referencing_string /
+// func:referenced_strings). One record per (function, string,
+// referencing instruction), built from the core's code references to
+// each GetStrings() entry.
+struct IndexedString {
+    uint64_t start;
+    size_t length;
+    BNStringType type;
+    std::string value;  // raw bytes, same decoding as bv:strings()
+};
+
+struct StringReference {
+    uint32_t func;    // index into StringIndex::functions
+    uint32_t string;  // index into StringIndex::strings
+    uint64_t address;
+};
+
+struct StringIndex {
+    uint64_t functionsGeneration = ~0ULL;
+    uint64_t stringsGeneration = ~0ULL;
+    std::vector<IndexedString> strings;  // address order
+    // Functions with at least one string reference, by start address.
+    std::vector<Ref<Function>> functions;
+    // Sorted by (func, string, address).
+    std::vector<StringReference> refs;
+    std::unordered_map<BNFunction*, uint32_t> functionIndex;
+};
+
+// Function name index (bv:lookup_functions). Names are the symbol
+// short names reported by Function.name. Lookups run against the
+// lower-cased names and are verified against the original spelling,
+// so one set of structures serves both case-sensitive and ignore_case
+// queries.
+struct NameIndex {
+    uint64_t functionsGeneration = ~0ULL;
+    uint64_t symbolsGeneration = ~0ULL;
+    std::vector<Ref<Function>> functions;  // start-address order
+    std::vector<std::string> names;
+    std::vector<std::string> lowered;
+    // Lower-cased name -> function indices, ascending.
+    std::unordered_map<std::string, std::vector<uint32_t>> exact;
+    // Function indices sorted by lower-cased name, for prefix ranges.
+    std::vector<uint32_t> sorted;
+    // Packed lower-cased byte trigram -> function indices, ascending.
+    // Candidate source for contains / regex queries.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+};
+
+// Symbol table partitioned by BNSymbolType (bv:imports / bv:exports /
+// get_symbols_of_type / symbols_page). Built from one GetSymbols()
+// pass, then patched from queued symbol add / remove notifications.
+struct IndexedSymbol {
+    uint64_t address;
+    std::string rawName;
+    Ref<Symbol> symbol;
+};
+
+struct SymbolIndex {
+    bool built = false;
+    // Each partition is sorted by (address, rawName).
+    std::map<BNSymbolType, std::vector<IndexedSymbol>> byType;
+};
+
+struct SymbolChange {
+    Ref<Symbol> symbol;
+    bool added;
+};
+
+// Half-open [start, end) intervals sorted by start, with a running
+// maximum of end so stabbing queries can stop scanning backwards as
+// soon as no earlier interval can still reach the address. T needs
+// uint64_t start / end members.
+template <typename T>
+struct IntervalSet {
+    std::vector<T> items;
+    std::vector<uint64_t> maxEnd;
+
+    void Finish() {
+        std::sort(items.begin(), items.end(),
+                  [](const T& a, const T& b) { return a.start < b.start; });
+        maxEnd.resize(items.size());
+        uint64_t reach = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            reach = std::max(reach, items[i].end);
+            maxEnd[i] = reach;
+        }
+    }
+
+    // Calls fn(item) for every interval containing addr, latest start
+    // first.
+    template <typename F>
+    void Stab(uint64_t addr, F&& fn) const {
+        auto it = std::upper_bound(
+            items.begin(), items.end(), addr,
+            [](uint64_t a, const T& item) { return a < item.start; });
+        for (size_t i = static_cast<size_t>(it - items.begin()); i-- > 0;) {
+            if (maxEnd[i] <= addr) break;
+            if (items[i].end > addr) fn(items[i]);
+        }
+    }
+};
+
+// Address-ownership index (bv:classify_addresses). Basic blocks come
+// from per-function slices so reanalysis only rescans the changed
+// functions; data variables, sections and tags are rebuilt whole when
+// their own generation moves.
+struct BlockInterval {
+    uint64_t start;
+    uint64_t end;
+    Ref<BasicBlock> block;
+    uint32_t func;  // index into FunctionSliceCache::functions
+};
+
+struct DataVariableInterval {
+    uint64_t start;
+    uint64_t end;
+    DataVariable var;
+};
+
+struct SectionInterval {
+    uint64_t start;
+    uint64_t end;
+    Ref<Section> section;
+};
+
+struct AddressIndex {
+    FunctionSliceCache<std::vector<BlockInterval>> blockSlices;
+    IntervalSet<BlockInterval> blocks;
+    uint64_t dataVariablesGeneration = ~0ULL;
+    IntervalSet<DataVariableInterval> dataVariables;
+    uint64_t sectionsGeneration = ~0ULL;
+    IntervalSet<SectionInterval> sections;
+    uint64_t tagsGeneration = ~0ULL;
+    std::vector<TagReference> tags;  // data tags, sorted by address
+};
+
+// Strongly connected components of a CallGraph (Tarjan) and the
+// derived condensation DAG. Components are numbered in the order
+// Tarjan completes them, which is reverse topological: a callee's
+// component never has a larger id than its caller's, so ascending ids
+// are a bottom-up schedule and descending ids a top-down one.
+struct CallGraphComponents {
+    std::vector<uint32_t> id;  // component of each node
+    // Members of component c: nodes[offsets[c] .. offsets[c+1]), ascending.
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> nodes;
+    // Condensation DAG: callee components of c, unique and ascending,
+    // in dag[dagOffsets[c] .. dagOffsets[c+1]).
+    std::vector<uint32_t> dagOffsets;
+    std::vector<uint32_t> dag;
+    // Component has more than one member or a self-call.
+    std::vector<uint8_t> recursive;
+    // Longest call chain (in DAG edges) below each component.
+    std::vector<uint32_t> height;
+
+    size_t Count() const { return recursive.size(); }
+};
+
+// Whole-binary call graph (bv:call_graph, Function.calls / callers /
+// callees / callee_addresses). Nodes are the analysis functions in
+// start-address order; edges are unique (caller, callee) pairs in CSR
+// form, with the number of call sites behind each edge alongside.
+// Published as an immutable snapshot so Lua can keep using a graph
+// while the index rebuilds the next one.
+struct CallGraph {
+    std::vector<Ref<Function>> functions;
+    std::unordered_map<BNFunction*, uint32_t> index;
+    // Callees of node i: callees[calleeOffsets[i] .. calleeOffsets[i+1]),
+    // ascending, with calleeSites[e] call sites for edge e. Same layout
+    // for the reverse edges, which also keep callers on another
+    // platform than the callee (GetCallers semantics), so they are a
+    // superset of the transposed callee edges.
+    std::vector<uint32_t> calleeOffsets;
+    std::vector<uint32_t> callees;
+    std::vector<uint32_t> calleeSites;
+    std::vector<uint32_t> callerOffsets;
+    std::vector<uint32_t> callers;
+    std::vector<uint32_t> callerSites;
+    // Total call sites out of / into each node.
+    std::vector<uint32_t> outSites;
+    std::vector<uint32_t> inSites;
+    // Every call target of node i, resolved to a function or not,
+    // sorted and unique: targets[targetOffsets[i] .. targetOffsets[i+1]).
+    std::vector<uint32_t> targetOffsets;
+    std::vector<uint64_t> targets;
+
+    size_t NodeCount() const { return functions.size(); }
+    size_t EdgeCount() const { return callees.size(); }
+    std::optional<uint32_t> IndexOf(BNFunction* func) const {
+        auto it = index.find(func);
+        if (it == index.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Computed on first use and cached for the snapshot's lifetime.
+    const CallGraphComponents& Components() const;
+
+private:
+    mutable std::once_flag m_componentsOnce;
+    mutable std::unique_ptr<CallGraphComponents> m_components;
+};
+
+struct CallSlice {
+    BNPlatform* platform = nullptr;
+    // One entry per (call site, target) pair, in call-site order.
+    std::vector<uint64_t> targets;
+};
+
+struct CallGraphIndex {
+    FunctionSliceCache<CallSlice> slices;
+    std::shared_ptr<CallGraph> graph;
+};
+
+// Cheap per-function facts (func:summary(), Function.is_thunk, the
+// fluent thunk filters). Computed once per function version; only the
+// exported flag is refreshed when symbols change.
+struct FunctionSummary {
+    size_t blockCount = 0;
+    size_t edgeCount = 0;
+    size_t instructionCount = 0;
+    int64_t cyclomaticComplexity = 0;  // FunctionCfg::CyclomaticComplexity
+    bool isThunk = false;
+    bool isExported = false;
+    bool hasLoops = false;  // any retreating edge in the native CFG
+};
+
+struct FunctionSummaryCache {
+    struct Entry {
+        Ref<Function> func;
+        uint64_t version = 0;
+        uint64_t symbolsGeneration = 0;
+        FunctionSummary summary;
+    };
+
+    std::unordered_map<BNFunction*, Entry> entries;
+    // Analysis function count at the last prune. Entries of removed
+    // functions are dropped once the map outgrows it.
+    size_t liveCount = 0;
+};
+
+// Instruction boundaries per basic block (BasicBlock.instruction_count
+// / instructions / instruction_arrays). Decoded once per function
+// version from a single read of each block's bytes. Lengths come from
+// instruction info alone; mnemonics need instruction text, so they are
+// only decoded once something asks for them, and are interned per view
+// so blocks can hand out small integer ids.
+struct BlockInstructions {
+    std::vector<uint64_t> addresses;
+    std::vector<uint16_t> lengths;
+    // Ids into InstructionCache::mnemonicNames; 0 = not decodable.
+    // Empty unless the decode included mnemonics.
+    std::vector<uint32_t> mnemonics;
+};
+
+struct FunctionInstructions {
+    uint64_t version = 0;
+    bool hasMnemonics = false;
+    std::unordered_map<uint64_t, BlockInstructions> blocks;  // by start
+};
+
+struct InstructionCache {
+    struct Entry {
+        Ref<Function> func;
+        std::shared_ptr<const FunctionInstructions> instructions;
+    };
+
+    std::unordered_map<BNFunction*, Entry> entries;
+    size_t liveCount = 0;  // see FunctionSummaryCache
+    std::vector<std::string> mnemonicNames{"<unknown>"};
+    std::unordered_map<std::string, uint32_t> mnemonicIds;
+};
+
+class ViewIndex {
+public:
+    ViewIndex() = default;
+    ViewIndex(const ViewIndex&) = delete;
+    ViewIndex& operator=(const ViewIndex&) = delete;
+
+    // Bumped on every function add / remove / update notification.
+    uint64_t FunctionsGeneration() const {
+        return m_functionsGeneration.load(std::memory_order_acquire);
+    }
+
+    // Monotonic per-function version; 0 for functions that have not
+    // changed since the index was created.
+    uint64_t FunctionVersion(BNFunction* func) const;
+
+    // Bumped when the core finds or drops a string.
+    uint64_t StringsGeneration() const {
+        return m_stringsGeneration.load(std::memory_order_acquire);
+    }
+
+    // Bumped on every symbol add / remove / update (renames included).
+    uint64_t SymbolsGeneration() const {
+        return m_symbolsGeneration.load(std::memory_order_acquire);
+    }
+
+    // Bumped on data variable, section and tag changes respectively.
+    uint64_t DataVariablesGeneration() const {
+        return m_dataVariablesGeneration.load(std::memory_order_acquire);
+    }
+    uint64_t SectionsGeneration() const {
+        return m_sectionsGeneration.load(std::memory_order_acquire);
+    }
+    uint64_t TagsGeneration() const {
+        return m_tagsGeneration.load(std::memory_order_acquire);
+    }
+
+    // Called from the notification on analysis threads.
+    void MarkFunctionChanged(BNFunction* func, bool removed);
+    void MarkDataVariablesChanged() {
+        m_dataVariablesGeneration.fetch_add(1, std::memory_order_release);
+    }
+    void MarkSectionsChanged() {
+        m_sectionsGeneration.fetch_add(1, std::memory_order_release);
+    }
+    void MarkTagsChanged() {
+        m_tagsGeneration.fetch_add(1, std::memory_order_release);
+    }
+    void MarkStringsChanged() {
+        m_stringsGeneration.fetch_add(1, std::memory_order_release);
+    }
+    void MarkSymbolsChanged();
+    void MarkSymbolAdded(Symbol* sym) { QueueSymbolChange(sym, true); }
+    void MarkSymbolRemoved(Symbol* sym) { QueueSymbolChange(sym, false); }
+
+    // Start queueing symbol adds / removes for the symbol partition.
+    // Call before taking the GetSymbols() snapshot; changes racing with
+    // the snapshot are queued too and must be applied idempotently.
+    void BeginSymbolSnapshot();
+    // Move the queued changes into out. Returns false when the queue
+    // cannot describe what happened (an update event, or overflow) and
+    // the partition has to be rebuilt from a fresh snapshot.
+    bool TakeSymbolChanges(std::vector<SymbolChange>& out);
+
+    // Serialises rebuilds and reads of the indexes below. Never taken
+    // by the notification callbacks, so holding it across core calls
+    // cannot deadlock against analysis.
+    std::mutex& Mutex() { return m_mutex; }
+
+    ConstantIndex constants;
+    StringIndex strings;
+    NameIndex names;
+    SymbolIndex symbols;
+    AddressIndex addresses;
+    CallGraphIndex callGraph;
+    FunctionSummaryCache summaries;
+    InstructionCache instructions;
+    // Scalar CFG metrics per function (bv:cfg_analytics).
+    FunctionSliceCache<CfgMetrics> cfgMetrics;
+
+private:
+    void QueueSymbolChange(Symbol* sym, bool added);
+
+    std::atomic<uint64_t> m_functionsGeneration{0};
+    std::atomic<uint64_t> m_stringsGeneration{0};
+    std::atomic<uint64_t> m_symbolsGeneration{0};
+    std::atomic<uint64_t> m_dataVariablesGeneration{0};
+    std::atomic<uint64_t> m_sectionsGeneration{0};
+    std::atomic<uint64_t> m_tagsGeneration{0};
+    mutable std::mutex m_versionMutex;
+    uint64_t m_versionCounter = 0;
+    std::unordered_map<BNFunction*, uint64_t> m_functionVersions;
+    std::mutex m_symbolMutex;
+    bool m_trackSymbols = false;
+    bool m_symbolsResync = false;
+    std::vector<SymbolChange> m_symbolChanges;
+    std::mutex m_mutex;
+};
+
+// Look up (creating on first use) the index for a view.
+std::shared_ptr<ViewIndex> GetViewIndex(BinaryView& bv);
+
+// Current call graph snapshot, rebuilt first if functions changed.
+std::shared_ptr<CallGraph> GetCallGraph(BinaryView& bv);
+
+// Cached summaries for funcs (all functions of bv), in input order.
+// Stale entries are recomputed in parallel.
+std::vector<FunctionSummary> GetFunctionSummaries(
+    BinaryView& bv, const std::vector<Ref<Function>>& funcs);
+FunctionSummary GetFunctionSummary(Function& func);
+
+// Cached instruction boundaries of block, or nullptr when it has no
+// function / view. With mnemonics, the decode is redone once with
+// instruction text if the cached one lacks them. The pointer shares
+// ownership of the whole function's decode.
+std::shared_ptr<const BlockInstructions> GetBlockInstructions(
+    BasicBlock& block, bool mnemonics = false);
+
+template <typename Slice>
+template <typename Build>
+bool FunctionSliceCache<Slice>::Refresh(ViewIndex& index, BinaryView& bv,
+                                        Build&& build) {
+    const uint64_t gen = index.FunctionsGeneration();
+    if (gen == generation) return false;
+
+    std::vector<Ref<Function>> current = bv.GetAnalysisFunctionList();
+    std::vector<uint64_t> versions(current.size());
+    std::vector<size_t> stale;
+    std::unordered_set<BNFunction*> live;
+    live.reserve(current.size());
+    for (size_t i = 0; i < current.size(); ++i) {
+        BNFunction* key = current[i]->GetObject();
+        live.insert(key);
+        versions[i] = index.FunctionVersion(key);
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.version != versions[i]) {
+            stale.push_back(i);
+        }
+    }
+
+    size_t dropped = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (live.count(it->first) == 0) {
+            it = entries.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+
+    std::vector<Slice> built(stale.size());
+    ParallelFor(stale.size(), [&](size_t k) {
+        built[k] = build(current[stale[k]]);
+    });
+    for (size_t k = 0; k < stale.size(); ++k) {
+        const Ref<Function>& func = current[stale[k]];
+        Entry& entry = entries[func->GetObject()];
+        entry.func = func;
+        entry.version = versions[stale[k]];
+        entry.slice = std::move(built[k]);
+    }
+
+    const bool changed = !stale.empty() || dropped != 0 ||
+                         current.size() != functions.size();
+    functions = std::move(current);
+    generation = gen;
+    return changed;
+}
+
+// Criteria for LookupFunctionNames. Empty / unset fields are ignored;
+// the remaining ones are combined with AND.
+struct NameQuery {
+    std::optional<std::string> exact;
+    std::optional<std::string> prefix;
+    std::optional<std::string> contains;
+    std::optional<std::string> regex;  // ECMAScript, std::regex_search
+    bool ignoreCase = false;
+    size_t limit = 0;  // 0 = unlimited
+};
+
+// Functions matching every criterion in query, in start-address order.
+// Throws std::regex_error for a malformed query.regex.
+std::vector<Ref<Function>> LookupFunctionNames(BinaryView& bv,
+                                               const NameQuery& query);
+
+// Lua-facing queries, bound on the BinaryView usertype.
+sol::table BinaryViewConstantUses(sol::this_state ts, BinaryView& bv,
+                                  sol::object value);
+sol::table BinaryViewConstantsInRange(sol::this_state ts, BinaryView& bv,
+                                      sol::object lo, sol::object hi);
+sol::table BinaryViewFunctionsReferencingString(sol::this_state ts,
+                                                BinaryView& bv,
+                                                const std::string& pattern,
+                                                sol::optional<sol::table> opts);
+sol::table BinaryViewLookupFunctions(sol::this_state ts, BinaryView& bv,
+                                     sol::table query);
+sol::table BinaryViewImports(sol::this_state ts, BinaryView& bv);
+sol::table BinaryViewExports(sol::this_state ts, BinaryView& bv);
+sol::table BinaryViewSymbolsOfType(sol::this_state ts, BinaryView& bv,
+                                   const std::string& type_name);
+std::tuple<sol::table, size_t> BinaryViewSymbolsPage(
+    sol::this_state ts, BinaryView& bv, const std::string& type_name,
+    size_t offset, size_t count);
+sol::table BinaryViewClassifyAddresses(sol::this_state ts, BinaryView& bv,
+                                       sol::table addrs,
+                                       sol::optional<sol::table> opts);
+sol::table BinaryViewXrefsBatch(sol::this_state ts, BinaryView& bv,
+                                sol::table addrs,
+                                sol::optional<sol::table> opts);
+sol::table BinaryViewSummarizeBottomUp(sol::this_state ts, BinaryView& bv,
+                                       sol::function callback,
+                                       sol::optional<sol::table> opts);
+sol::table BinaryViewProject(sol::this_state ts, BinaryView& bv,
+                             const std::string& kind, sol::table fields,
+                             sol::optional<sol::table> opts);
+sol::table BinaryViewFunctionSummaries(sol::this_state ts, BinaryView& bv,
+                                       sol::optional<sol::table> funcs);
+
+// Single-block LLIL tailcall check behind Function.is_thunk.
+bool FunctionIsThunk(Function& func);
+
+// Bound on the Function usertype.
+sol::table FunctionReferencedStrings(sol::this_state ts, Function& func);
+sol::table FunctionCalls(sol::this_state ts, Function& func);
+sol::table FunctionCallers(sol::this_state ts, Function& func);
+sol::table FunctionCallees(sol::this_state ts, Function& func);
+sol::table FunctionCalleeAddresses(sol::this_state ts, Function& func);
+sol::table FunctionSummaryTable(sol::this_state ts, Function& func);
+
+// BinaryView.opcode_histogram.
+sol::table BinaryViewOpcodeHistogram(sol::this_state ts, BinaryView& bv,
+                                     sol::optional<sol::table> opts);
+
+// Bound on the BasicBlock usertype.
+sol::table BasicBlockInstructionArrays(sol::this_state ts, BasicBlock& block);
+
+}  // namespace BinjaLua
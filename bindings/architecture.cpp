@@ -7,9 +7,15 @@
 
 #include "common.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace BinjaLua {
@@ -107,6 +113,267 @@ sol::table InstructionTextTokensToTable(
     return result;
 }
 
+// Name -> id maps for the by-name Architecture methods, built once per
+// architecture on first use. Core architectures are never freed, so
+// the process-wide cache is keyed by the BNArchitecture pointer.
+struct ArchitectureNameIndex {
+    std::unordered_map<std::string, uint32_t> registers;
+    std::unordered_map<std::string, uint32_t> flags;
+    std::unordered_map<std::string, uint32_t> flagWriteTypes;
+    std::unordered_map<std::string, uint32_t> semanticClasses;
+    std::unordered_map<std::string, uint32_t> semanticGroups;
+    std::unordered_map<std::string, uint32_t> intrinsics;
+};
+
+template <typename NameOf>
+void IndexNames(std::unordered_map<std::string, uint32_t>& out,
+                const std::vector<uint32_t>& ids, NameOf name_of) {
+    out.reserve(ids.size());
+    for (uint32_t id : ids) {
+        std::string name = name_of(id);
+        if (!name.empty()) out.emplace(std::move(name), id);
+    }
+}
+
+const ArchitectureNameIndex& NameIndexFor(Architecture& a) {
+    static std::mutex mutex;
+    static std::unordered_map<BNArchitecture*,
+                              std::unique_ptr<ArchitectureNameIndex>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<ArchitectureNameIndex>& slot =
+        cache[Architecture::GetObject(&a)];
+    if (!slot) {
+        auto index = std::make_unique<ArchitectureNameIndex>();
+        IndexNames(index->registers, a.GetAllRegisters(),
+                   [&](uint32_t id) { return a.GetRegisterName(id); });
+        IndexNames(index->flags, a.GetAllFlags(),
+                   [&](uint32_t id) { return a.GetFlagName(id); });
+        IndexNames(index->flagWriteTypes, a.GetAllFlagWriteTypes(),
+                   [&](uint32_t id) { return a.GetFlagWriteTypeName(id); });
+        IndexNames(index->semanticClasses, a.GetAllSemanticFlagClasses(),
+                   [&](uint32_t id) { return a.GetSemanticFlagClassName(id); });
+        IndexNames(index->semanticGroups, a.GetAllSemanticFlagGroups(),
+                   [&](uint32_t id) { return a.GetSemanticFlagGroupName(id); });
+        IndexNames(index->intrinsics, a.GetAllIntrinsics(),
+                   [&](uint32_t id) { return a.GetIntrinsicName(id); });
+        slot = std::move(index);
+    }
+    return *slot;
+}
+
+std::optional<uint32_t> LookupName(
+    const std::unordered_map<std::string, uint32_t>& names,
+    const std::string& name) {
+    auto it = names.find(name);
+    if (it == names.end()) return std::nullopt;
+    return it->second;
+}
+
+sol::object IndexOrNil(sol::this_state ts,
+                       const std::unordered_map<std::string, uint32_t>& names,
+                       const std::string& name) {
+    sol::state_view lua(ts);
+    auto id = LookupName(names, name);
+    if (!id) return sol::make_object(lua, sol::nil);
+    return sol::make_object(lua, *id);
+}
+
+// Linear-sweep decoder behind Architecture:disassemble_range. Owns a
+// copy of the bytes so the streaming form can outlive the Lua string,
+// and reuses one token vector / text buffer across instructions.
+class RangeDisassembler {
+public:
+    struct Decoded {
+        uint64_t addr = 0;
+        size_t length = 0;
+        bool valid = false;
+        InstructionInfo info;
+        std::string mnemonic;
+        std::string text;
+    };
+
+    RangeDisassembler(Ref<Architecture> arch, std::string bytes,
+                      uint64_t base, bool withText, size_t limit)
+        : m_arch(std::move(arch)), m_bytes(std::move(bytes)), m_base(base),
+          m_withText(withText), m_limit(limit),
+          m_invalidStep(std::max<size_t>(1, m_arch->GetInstructionAlignment())) {}
+
+    bool WithText() const { return m_withText; }
+
+    // Decode the next instruction; false once the range (or the
+    // instruction limit) is exhausted. Undecodable bytes yield an
+    // invalid entry one alignment unit long so the sweep continues.
+    bool Next(Decoded& out) {
+        if (m_offset >= m_bytes.size() || m_decoded >= m_limit) return false;
+        const uint8_t* data =
+            reinterpret_cast<const uint8_t*>(m_bytes.data()) + m_offset;
+        const size_t available = m_bytes.size() - m_offset;
+
+        out.addr = m_base + m_offset;
+        out.info = InstructionInfo();
+        out.mnemonic.clear();
+        out.text.clear();
+        out.valid = m_arch->GetInstructionInfo(data, out.addr, available,
+                                               out.info) &&
+                    out.info.length > 0 && out.info.length <= available;
+        out.length = out.valid ? out.info.length
+                               : std::min(m_invalidStep, available);
+
+        if (out.valid && m_withText) {
+            size_t len = out.length;
+            m_tokens.clear();
+            if (m_arch->GetInstructionText(data, out.addr, len, m_tokens)) {
+                for (const auto& token : m_tokens) {
+                    if (out.mnemonic.empty() && token.type == InstructionToken) {
+                        out.mnemonic = token.text;
+                    }
+                    out.text += token.text;
+                }
+            }
+        }
+
+        m_offset += out.length;
+        ++m_decoded;
+        return true;
+    }
+
+private:
+    Ref<Architecture> m_arch;
+    std::string m_bytes;
+    uint64_t m_base;
+    bool m_withText;
+    size_t m_limit;
+    size_t m_invalidStep;
+    size_t m_offset = 0;
+    size_t m_decoded = 0;
+    std::vector<InstructionTextToken> m_tokens;
+};
+
+sol::table DecodedToRecord(sol::state_view lua,
+                           const RangeDisassembler::Decoded& d,
+                           bool withText) {
+    sol::table t = lua.create_table(0, 8);
+    t["address"]      = HexAddress(d.addr);
+    t["length"]       = d.length;
+    t["valid"]        = d.valid;
+    t["branch_count"] = d.info.branchCount;
+    if (d.info.branchCount > 0) {
+        t["branch_type"]   = EnumToString(d.info.branchType[0]);
+        t["branch_target"] = HexAddress(d.info.branchTarget[0]);
+    }
+    if (withText && d.valid) {
+        t["mnemonic"] = d.mnemonic;
+        t["text"]     = d.text;
+    }
+    return t;
+}
+
+// Architecture:disassemble_range(source, base[, opts]). source is a
+// byte string, or a BinaryView to read opts.length bytes from at base.
+// Returns columnar results, or an iterator when opts.stream is set.
+sol::object DisassembleRange(sol::this_state ts, Architecture& a,
+                             sol::object source, sol::object base_obj,
+                             sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    auto base = AsAddress(base_obj);
+    if (!base) return sol::make_object(lua, sol::nil);
+
+    const bool withText = opts ? opts->get_or("text", true) : true;
+    const bool stream = opts ? opts->get_or("stream", false) : false;
+    const size_t limit = opts
+        ? opts->get_or("max_instructions", std::numeric_limits<size_t>::max())
+        : std::numeric_limits<size_t>::max();
+
+    std::string bytes;
+    if (source.is<std::string>()) {
+        bytes = source.as<std::string>();
+    } else if (source.is<BinaryView>()) {
+        sol::optional<size_t> length;
+        if (opts) length = opts->get<sol::optional<size_t>>("length");
+        if (!length) {
+            GetLogger(lua)->LogWarn(
+                "disassemble_range: opts.length is required when reading from a BinaryView");
+            return sol::make_object(lua, sol::nil);
+        }
+        DataBuffer data = source.as<BinaryView&>().ReadBuffer(*base, *length);
+        bytes.assign(static_cast<const char*>(data.GetData()), data.GetLength());
+    } else {
+        GetLogger(lua)->LogWarn(
+            "disassemble_range: source must be a byte string or a BinaryView");
+        return sol::make_object(lua, sol::nil);
+    }
+
+    auto decoder = std::make_shared<RangeDisassembler>(
+        Ref<Architecture>(&a), std::move(bytes), *base, withText, limit);
+
+    if (stream) {
+        return sol::make_object(lua, [decoder](sol::this_state ts) -> sol::object {
+            sol::state_view lua(ts);
+            RangeDisassembler::Decoded d;
+            if (!decoder->Next(d)) return sol::make_object(lua, sol::nil);
+            return sol::make_object(
+                lua, DecodedToRecord(lua, d, decoder->WithText()));
+        });
+    }
+
+    sol::table address = lua.create_table();
+    sol::table length = lua.create_table();
+    sol::table valid = lua.create_table();
+    sol::table branchCount = lua.create_table();
+    sol::table branchType = lua.create_table();
+    sol::table branchTarget = lua.create_table();
+    sol::table branches = lua.create_table();  // only multi-branch rows
+    sol::table mnemonic = lua.create_table();
+    sol::table text = lua.create_table();
+
+    RangeDisassembler::Decoded d;
+    int n = 0;
+    while (decoder->Next(d)) {
+        ++n;
+        address[n] = static_cast<lua_Integer>(d.addr);
+        length[n] = d.length;
+        valid[n] = d.valid;
+        branchCount[n] = d.info.branchCount;
+        if (d.info.branchCount > 0) {
+            branchType[n] = EnumToString(d.info.branchType[0]);
+            branchTarget[n] = static_cast<lua_Integer>(d.info.branchTarget[0]);
+        } else {
+            branchType[n] = false;
+            branchTarget[n] = false;
+        }
+        if (d.info.branchCount > 1) {
+            sol::table all = lua.create_table(
+                static_cast<int>(d.info.branchCount), 0);
+            for (size_t i = 0; i < d.info.branchCount; ++i) {
+                all[i + 1] = lua.create_table_with(
+                    "type", EnumToString(d.info.branchType[i]),
+                    "target", static_cast<lua_Integer>(d.info.branchTarget[i]));
+            }
+            branches[n] = all;
+        }
+        if (withText) {
+            mnemonic[n] = d.mnemonic;
+            text[n] = d.text;
+        }
+    }
+
+    sol::table result = lua.create_table(0, 10);
+    result["count"] = n;
+    result["address"] = address;
+    result["length"] = length;
+    result["valid"] = valid;
+    result["branch_count"] = branchCount;
+    result["branch_type"] = branchType;
+    result["branch_target"] = branchTarget;
+    result["branches"] = branches;
+    if (withText) {
+        result["mnemonic"] = mnemonic;
+        result["text"] = text;
+    }
+    return sol::make_object(lua, result);
+}
+
 }  // namespace
 
 void RegisterArchitectureBindings(sol::state_view lua, Ref<Logger> logger) {
@@ -203,6 +470,11 @@ void RegisterArchitectureBindings(sol::state_view lua, Ref<Logger> logger) {
 
         "get_reg_index", [](Architecture& a, const std::string& name)
                              -> uint32_t {
+            // Names outside the enumeration (LLIL temporaries) still go
+            // to the core.
+            if (auto id = LookupName(NameIndexFor(a).registers, name)) {
+                return *id;
+            }
             return a.GetRegisterByName(name);
         },
 
@@ -284,26 +556,50 @@ void RegisterArchitectureBindings(sol::state_view lua, Ref<Logger> logger) {
         "get_flag_role", sol::overload(
             [](Architecture& a, const std::string& flag_name)
                 -> std::string {
-                std::vector<uint32_t> flags = a.GetAllFlags();
-                for (uint32_t flag : flags) {
-                    if (a.GetFlagName(flag) == flag_name) {
-                        return EnumToString(a.GetFlagRole(flag, 0));
-                    }
-                }
-                return "unknown";
+                auto flag = LookupName(NameIndexFor(a).flags, flag_name);
+                if (!flag) return "unknown";
+                return EnumToString(a.GetFlagRole(*flag, 0));
             },
             [](Architecture& a, const std::string& flag_name,
                uint32_t sem_class) -> std::string {
-                std::vector<uint32_t> flags = a.GetAllFlags();
-                for (uint32_t flag : flags) {
-                    if (a.GetFlagName(flag) == flag_name) {
-                        return EnumToString(a.GetFlagRole(flag, sem_class));
-                    }
-                }
-                return "unknown";
+                auto flag = LookupName(NameIndexFor(a).flags, flag_name);
+                if (!flag) return "unknown";
+                return EnumToString(a.GetFlagRole(*flag, sem_class));
             }
         ),
 
+        // Name -> index lookups (nil for unknown names)
+
+        "get_flag_index", [](sol::this_state ts, Architecture& a,
+                             const std::string& name) -> sol::object {
+            return IndexOrNil(ts, NameIndexFor(a).flags, name);
+        },
+
+        "get_flag_write_type_index", [](sol::this_state ts, Architecture& a,
+                                        const std::string& name)
+                                        -> sol::object {
+            return IndexOrNil(ts, NameIndexFor(a).flagWriteTypes, name);
+        },
+
+        "get_semantic_flag_class_index", [](sol::this_state ts,
+                                            Architecture& a,
+                                            const std::string& name)
+                                            -> sol::object {
+            return IndexOrNil(ts, NameIndexFor(a).semanticClasses, name);
+        },
+
+        "get_semantic_flag_group_index", [](sol::this_state ts,
+                                            Architecture& a,
+                                            const std::string& name)
+                                            -> sol::object {
+            return IndexOrNil(ts, NameIndexFor(a).semanticGroups, name);
+        },
+
+        "get_intrinsic_index", [](sol::this_state ts, Architecture& a,
+                                  const std::string& name) -> sol::object {
+            return IndexOrNil(ts, NameIndexFor(a).intrinsics, name);
+        },
+
         // Decoding raw bytes
 
         "get_instruction_info", [](sol::this_state ts, Architecture& a,
@@ -350,6 +646,8 @@ void RegisterArchitectureBindings(sol::state_view lua, Ref<Logger> logger) {
             return std::make_tuple(sol::make_object(l, tok_table), len);
         },
 
+        "disassemble_range", &DisassembleRange,
+
         // Cross-arch helper: returns (arch, new_addr).
 
         "get_associated_arch_by_address",
@@ -1,6 +1,8 @@
 // Sol2 BasicBlock bindings for binja-lua
 
 #include "common.h"
+#include "analysis_index.h"
+#include <algorithm>
 
 namespace BinjaLua {
 
@@ -74,23 +76,8 @@ void RegisterBasicBlockBindings(sol::state_view lua, Ref<Logger> logger) {
 
         // Instruction count
         "instruction_count", [](BasicBlock& b) -> size_t {
-            Ref<Architecture> arch = b.GetArchitecture();
-            Ref<Function> func = b.GetFunction();
-            if (!func) return 0;
-            Ref<BinaryView> view = func->GetView();
-            if (!view || !arch) return 0;
-
-            uint64_t addr = b.GetStart();
-            uint64_t end = b.GetEnd();
-            size_t count = 0;
-
-            while (addr < end) {
-                size_t instrLen = view->GetInstructionLength(arch, addr);
-                if (instrLen == 0) instrLen = 1;
-                count++;
-                addr += instrLen;
-            }
-            return count;
+            auto insns = GetBlockInstructions(b);
+            return insns ? insns->addresses.size() : 0;
         },
 
         // Edge methods
@@ -313,29 +300,32 @@ void RegisterBasicBlockBindings(sol::state_view lua, Ref<Logger> logger) {
             sol::state_view lua(ts);
             sol::table result = lua.create_table();
 
-            Ref<Function> func = b.GetFunction();
+            auto insns = GetBlockInstructions(b);
             Ref<Architecture> arch = b.GetArchitecture();
-            if (!func || !arch) return result;
+            if (!insns || !arch) return result;
+            Ref<BinaryView> view = b.GetFunction()->GetView();
 
-            Ref<BinaryView> view = func->GetView();
-            if (!view) return result;
+            // One read for the whole block; boundaries come from the cache.
+            const uint64_t start = b.GetStart();
+            DataBuffer data = view->ReadBuffer(start, b.GetLength());
+            const uint8_t* bytes = static_cast<const uint8_t*>(data.GetData());
+            const size_t available = data.GetLength();
 
-            uint64_t addr = b.GetStart();
-            uint64_t end = b.GetEnd();
-            int idx = 1;
-
-            while (addr < end) {
-                size_t len = view->GetInstructionLength(arch, addr);
-                if (len == 0) len = 1;
+            std::vector<InstructionTextToken> tokens;
+            for (size_t i = 0; i < insns->addresses.size(); ++i) {
+                const uint64_t addr = insns->addresses[i];
+                const size_t offset = static_cast<size_t>(addr - start);
+                size_t len = insns->lengths[i];
 
                 sol::table instr = lua.create_table();
                 instr["addr"] = HexAddress(addr);
                 instr["length"] = len;
 
-                std::vector<InstructionTextToken> tokens;
-                DataBuffer data = view->ReadBuffer(addr, len);
-                const uint8_t* dataPtr = static_cast<const uint8_t*>(data.GetData());
-                if (arch->GetInstructionText(dataPtr, addr, len, tokens)) {
+                const size_t readable = offset < available
+                    ? std::min(len, available - offset) : 0;
+                size_t decodeLen = readable;
+                tokens.clear();
+                if (readable && arch->GetInstructionText(bytes + offset, addr, decodeLen, tokens)) {
                     std::string text;
                     for (const auto& tok : tokens) {
                         text += tok.text;
@@ -344,15 +334,15 @@ void RegisterBasicBlockBindings(sol::state_view lua, Ref<Logger> logger) {
                 }
 
                 instr["bytes"] = std::string(
-                    reinterpret_cast<const char*>(data.GetData()),
-                    data.GetLength());
+                    reinterpret_cast<const char*>(bytes + offset), readable);
 
-                result[idx++] = instr;
-                addr += len;
+                result[i + 1] = instr;
             }
             return result;
         },
 
+        "instruction_arrays", &BasicBlockInstructionArrays,
+
         // Comparison
         sol::meta_function::equal_to, [](BasicBlock& a, BasicBlock& b) -> bool {
             return a.GetStart() == b.GetStart() && a.GetEnd() == b.GetEnd();
@@ -1,6 +1,8 @@
 // Sol2 BinaryView bindings for binja-lua
 
 #include "common.h"
+#include "analysis_index.h"
+#include "cfg.h"
 #include <cmath>
 
 namespace BinjaLua {
@@ -72,30 +74,17 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
             return result;
         },
 
-        "imports", [](sol::this_state ts, BinaryView& bv) -> sol::table {
-            sol::state_view lua(ts);
-            std::vector<Ref<Symbol>> all = bv.GetSymbols();
-            sol::table result = lua.create_table();
-            int idx = 1;
-            for (const auto& sym : all) {
-                BNSymbolType t = sym->GetType();
-                if (t == ImportAddressSymbol || t == ImportedFunctionSymbol || t == ImportedDataSymbol)
-                    result[idx++] = sym;
-            }
-            return result;
-        },
+        // Which functions reference strings matching `pattern`
+        // (substring by default; opts.exact / opts.regex). Answered
+        // from the per-view string xref index, rebuilt once per
+        // analysis state instead of walking xrefs per address.
+        "functions_referencing_string", &BinaryViewFunctionsReferencingString,
 
-        "exports", [](sol::this_state ts, BinaryView& bv) -> sol::table {
-            sol::state_view lua(ts);
-            std::vector<Ref<Symbol>> all = bv.GetSymbols();
-            sol::table result = lua.create_table();
-            int idx = 1;
-            for (const auto& sym : all) {
-                BNSymbolType t = sym->GetType();
-                if (t == FunctionSymbol || t == DataSymbol) result[idx++] = sym;
-            }
-            return result;
-        },
+        // Served from the per-view symbol-type partition; symbols_page
+        // streams one type in (address, raw name) order.
+        "imports", &BinaryViewImports,
+        "exports", &BinaryViewExports,
+        "symbols_page", &BinaryViewSymbolsPage,
 
         // Symbol CRUD
         "define_user_symbol", [](BinaryView& bv, Ref<Symbol> sym) {
@@ -126,15 +115,7 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
             return ToLuaTable(ts, bv.GetSymbolsByName(name));
         },
 
-        "get_symbols_of_type", [](sol::this_state ts, BinaryView& bv,
-                                  const std::string& type_name) -> sol::table {
-            sol::state_view lua(ts);
-            auto type = EnumFromString<BNSymbolType>(type_name);
-            if (!type) {
-                return lua.create_table();
-            }
-            return ToLuaTable(ts, bv.GetSymbolsOfType(*type));
-        },
+        "get_symbols_of_type", &BinaryViewSymbolsOfType,
 
         // Data variable properties
         "has_data_vars", sol::property([](BinaryView& bv) -> bool {
@@ -334,6 +315,11 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
             return ToLuaTable(ts, bv.GetAnalysisFunctionsContainingAddress(*addr));
         },
 
+        // Owning function / block / data var / section (and optionally
+        // data tags) for many addresses at once, from the per-view
+        // interval index.
+        "classify_addresses", &BinaryViewClassifyAddresses,
+
         "get_basic_blocks_starting_at", [](sol::this_state ts, BinaryView& bv, sol::object addr_obj)
             -> sol::table {
             auto addr = AsAddress(addr_obj);
@@ -345,27 +331,17 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
         "get_functions_by_name", [](sol::this_state ts, BinaryView& bv,
                                     const std::string& name,
                                     sol::optional<bool> exact) -> sol::table {
-            sol::state_view lua(ts);
-            sol::table result = lua.create_table();
-            bool exactMatch = exact.value_or(true);
-
-            std::vector<Ref<Function>> allFuncs = bv.GetAnalysisFunctionList();
-            int idx = 1;
-            for (const auto& func : allFuncs) {
-                std::string funcName = func->GetSymbol()->GetShortName();
-                bool match = false;
-                if (exactMatch) {
-                    match = (funcName == name);
-                } else {
-                    match = (funcName.find(name) != std::string::npos);
-                }
-                if (match) {
-                    result[idx++] = func;
-                }
+            NameQuery query;
+            if (exact.value_or(true)) {
+                query.exact = name;
+            } else {
+                query.contains = name;
             }
-            return result;
+            return ToLuaTable(ts, LookupFunctionNames(bv, query));
         },
 
+        "lookup_functions", &BinaryViewLookupFunctions,
+
         // Search functions
         "find_next_data", [](BinaryView& bv, sol::object start_obj,
                             const std::string& data) -> std::optional<HexAddress> {
@@ -459,6 +435,14 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
             return HexAddress(resultAddr);
         },
 
+        // Indexed constant search. find_next_constant above walks one
+        // match at a time; these answer "every use of X" from the
+        // per-view LLIL immediate index (bindings/analysis_index.cpp),
+        // built in parallel on first use and refreshed per function
+        // when analysis updates it.
+        "constant_uses", &BinaryViewConstantUses,
+        "constants_in_range", &BinaryViewConstantsInRange,
+
         "read", [](BinaryView& bv, uint64_t addr, size_t len) -> std::string {
             DataBuffer buf = bv.ReadBuffer(addr, len);
             return std::string((const char*)buf.GetData(), buf.GetLength());
@@ -501,6 +485,40 @@ void RegisterBinaryViewBindings(sol::state_view lua, Ref<Logger> logger) {
             return result;
         },
 
+        // Whole-binary call graph snapshot (CSR adjacency, 1-based
+        // function indices), rebuilt per changed function.
+        "call_graph", &GetCallGraph,
+
+        // Bottom-up summaries over the call graph: callback(func,
+        // callees) runs once every callee has a summary, recursion
+        // groups iterate to a fixpoint.
+        "summarize_bottom_up", &BinaryViewSummarizeBottomUp,
+
+        // Struct-of-arrays projection: project(kind, {field, ...})
+        // gathers the named fields for every object of a kind in one
+        // native pass instead of one property call per object.
+        "project", &BinaryViewProject,
+
+        // Batch func:summary() over a function list (default: all),
+        // recomputing stale entries on the worker pool.
+        "function_summaries", &BinaryViewFunctionSummaries,
+
+        // Columnar func:cfg_analytics() scalars for every function,
+        // cached per function and recomputed on the worker pool.
+        "cfg_analytics", &BinaryViewCfgAnalytics,
+
+        // Whole-binary instruction mix, per function and in total.
+        "opcode_histogram", &BinaryViewOpcodeHistogram,
+
+        // IL tree-pattern search over every function, matched on the
+        // worker pool.
+        "match_il", &BinaryViewMatchIL,
+
+        // Batch form of the xref getters above: columnar
+        // {from, to, func, kind, functions} over many addresses, core
+        // queries fanned out over the worker pool.
+        "xrefs_batch", &BinaryViewXrefsBatch,
+
         // Caller/callee methods
         "get_callers", [](sol::this_state ts, BinaryView& bv, uint64_t addr) -> sol::table {
             return ReferenceSourcesToTable(ts, bv.GetCallers(addr));
@@ -0,0 +1,781 @@
+// Sol2 control-flow graph bindings for binja-lua
+//
+// CSR snapshots of native basic-block graphs (bindings/cfg.h), the
+// graph algorithms that run over them, and their Lua projections
+// bound on the Function and BinaryView usertypes.
+
+#include "cfg.h"
+
+#include "analysis_index.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace BinjaLua {
+
+namespace {
+
+// Whole-binary entries only need the scalar metrics.
+CfgMetrics ScanFunctionCfg(const Ref<Function>& func) {
+    CfgMetrics metrics = AnalyzeCfg(BuildFunctionCfg(*func));
+    metrics.loopDepth = {};
+    metrics.loopHeaders = {};
+    metrics.loopSizes = {};
+    return metrics;
+}
+
+template <typename T>
+sol::table ColumnToTable(sol::state_view lua, const std::vector<T>& values) {
+    sol::table t = lua.create_table(static_cast<int>(values.size()), 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        t[i + 1] = static_cast<lua_Integer>(values[i]);
+    }
+    return t;
+}
+
+// Iterative DFS over a CSR graph from root; returns the reverse
+// postorder of the nodes reached.
+std::vector<uint32_t> ReversePostorder(const std::vector<uint32_t>& offsets,
+                                       const std::vector<uint32_t>& adj,
+                                       uint32_t root) {
+    const size_t n = offsets.size() - 1;
+    std::vector<uint8_t> visited(n, 0);
+    std::vector<uint32_t> postorder;
+    postorder.reserve(n);
+    // (node, next edge) frames
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back(root, offsets[root]);
+    visited[root] = 1;
+    while (!stack.empty()) {
+        const uint32_t v = stack.back().first;
+        uint32_t& e = stack.back().second;
+        if (e < offsets[v + 1]) {
+            const uint32_t w = adj[e++];
+            if (!visited[w]) {
+                visited[w] = 1;
+                stack.emplace_back(w, offsets[w]);
+            }
+            continue;
+        }
+        postorder.push_back(v);
+        stack.pop_back();
+    }
+    return std::vector<uint32_t>(postorder.rbegin(), postorder.rend());
+}
+
+// Cooper / Harvey / Kennedy iteration over a reverse postorder rooted
+// at order[0]. orderIndex is its inverse (kNoBlock off-order) and
+// predOffsets / preds the predecessor CSR of the same graph.
+std::vector<uint32_t> IterateDominators(const std::vector<uint32_t>& order,
+                                        const std::vector<uint32_t>& orderIndex,
+                                        const std::vector<uint32_t>& predOffsets,
+                                        const std::vector<uint32_t>& preds) {
+    std::vector<uint32_t> idom(orderIndex.size(), kNoBlock);
+    if (order.empty()) return idom;
+    const uint32_t root = order.front();
+    idom[root] = root;
+
+    auto intersect = [&](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (orderIndex[a] > orderIndex[b]) a = idom[a];
+            while (orderIndex[b] > orderIndex[a]) b = idom[b];
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t k = 1; k < order.size(); ++k) {
+            const uint32_t v = order[k];
+            uint32_t next = kNoBlock;
+            for (uint32_t e = predOffsets[v]; e < predOffsets[v + 1]; ++e) {
+                const uint32_t p = preds[e];
+                if (idom[p] == kNoBlock) continue;
+                next = next == kNoBlock ? p : intersect(p, next);
+            }
+            if (idom[v] != next) {
+                idom[v] = next;
+                changed = true;
+            }
+        }
+    }
+    idom[root] = kNoBlock;
+    return idom;
+}
+
+// Blocks reachable from root over the successor CSR, breadth-first.
+std::vector<uint32_t> BreadthFirstOrder(const FunctionCfg& cfg,
+                                        uint32_t root) {
+    std::vector<uint8_t> seen(cfg.BlockCount(), 0);
+    std::vector<uint32_t> order{root};
+    seen[root] = 1;
+    for (size_t k = 0; k < order.size(); ++k) {
+        const uint32_t v = order[k];
+        for (uint32_t e = cfg.succOffsets[v]; e < cfg.succOffsets[v + 1]; ++e) {
+            const uint32_t w = cfg.succs[e];
+            if (seen[w]) continue;
+            seen[w] = 1;
+            order.push_back(w);
+        }
+    }
+    return order;
+}
+
+// Depth-first preorder, successors visited in edge order.
+std::vector<uint32_t> DepthFirstPreorder(const FunctionCfg& cfg,
+                                         uint32_t root) {
+    std::vector<uint8_t> seen(cfg.BlockCount(), 0);
+    std::vector<uint32_t> order;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back(root, cfg.succOffsets[root]);
+    seen[root] = 1;
+    order.push_back(root);
+    while (!stack.empty()) {
+        const uint32_t v = stack.back().first;
+        uint32_t& e = stack.back().second;
+        if (e == cfg.succOffsets[v + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        const uint32_t w = cfg.succs[e++];
+        if (seen[w]) continue;
+        seen[w] = 1;
+        order.push_back(w);
+        stack.emplace_back(w, cfg.succOffsets[w]);
+    }
+    return order;
+}
+
+}  // namespace
+
+FunctionCfg BuildFunctionCfg(Function& func) {
+    FunctionCfg cfg;
+    cfg.func = &func;
+    cfg.blocks = func.GetBasicBlocks();
+    const size_t n = cfg.blocks.size();
+    cfg.starts.resize(n);
+    cfg.ends.resize(n);
+    std::unordered_map<BNBasicBlock*, uint32_t> position;
+    position.reserve(n);
+    const uint64_t entryAddr = func.GetStart();
+    for (size_t i = 0; i < n; ++i) {
+        position[cfg.blocks[i]->GetObject()] = static_cast<uint32_t>(i);
+        cfg.starts[i] = cfg.blocks[i]->GetStart();
+        cfg.ends[i] = cfg.blocks[i]->GetEnd();
+        if (cfg.entry == kNoBlock && cfg.starts[i] == entryAddr) {
+            cfg.entry = static_cast<uint32_t>(i);
+        }
+    }
+    if (n == 0) return cfg;
+    if (cfg.entry == kNoBlock) cfg.entry = 0;
+
+    std::vector<uint32_t> inDegree(n, 0);
+    cfg.succOffsets.reserve(n + 1);
+    cfg.succOffsets.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+        for (const BasicBlockEdge& edge : cfg.blocks[i]->GetOutgoingEdges()) {
+            if (!edge.target) continue;
+            auto it = position.find(edge.target->GetObject());
+            if (it == position.end()) continue;
+            cfg.succs.push_back(it->second);
+            cfg.edgeTypes.push_back(static_cast<uint8_t>(edge.type));
+            ++inDegree[it->second];
+        }
+        cfg.succOffsets.push_back(static_cast<uint32_t>(cfg.succs.size()));
+    }
+
+    cfg.predOffsets.assign(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+        cfg.predOffsets[v + 1] = cfg.predOffsets[v] + inDegree[v];
+    }
+    cfg.preds.resize(cfg.succs.size());
+    std::vector<uint32_t> fill(cfg.predOffsets.begin(), cfg.predOffsets.end() - 1);
+    for (size_t u = 0; u < n; ++u) {
+        for (uint32_t e = cfg.succOffsets[u]; e < cfg.succOffsets[u + 1]; ++e) {
+            cfg.preds[fill[cfg.succs[e]]++] = static_cast<uint32_t>(u);
+        }
+    }
+
+    cfg.rpo = ReversePostorder(cfg.succOffsets, cfg.succs, cfg.entry);
+    cfg.rpoIndex.assign(n, kNoBlock);
+    for (size_t k = 0; k < cfg.rpo.size(); ++k) {
+        cfg.rpoIndex[cfg.rpo[k]] = static_cast<uint32_t>(k);
+    }
+    return cfg;
+}
+
+void IndexBlockStarts(FunctionCfg& cfg) {
+    cfg.blockAt.reserve(cfg.BlockCount());
+    for (size_t i = 0; i < cfg.BlockCount(); ++i) {
+        cfg.blockAt.emplace(cfg.starts[i], static_cast<uint32_t>(i));
+    }
+}
+
+uint32_t FunctionCfg::IndexOf(BasicBlock& block) const {
+    // IL blocks start at instruction indices and blocks of other
+    // functions can share a start address; neither is a node.
+    Ref<Function> owner = block.GetFunction();
+    if (block.IsILBlock() || !owner || !func ||
+        owner->GetObject() != func->GetObject()) {
+        return kNoBlock;
+    }
+    auto it = blockAt.find(block.GetStart());
+    return it == blockAt.end() ? kNoBlock : it->second;
+}
+
+std::vector<uint32_t> ComputeDominators(const FunctionCfg& cfg) {
+    return IterateDominators(cfg.rpo, cfg.rpoIndex, cfg.predOffsets,
+                             cfg.preds);
+}
+
+std::vector<uint32_t> ComputePostDominators(const FunctionCfg& cfg) {
+    // Reverse graph plus the virtual exit: successors of a block are
+    // its CFG predecessors, successors of the exit are the CFG's exit
+    // blocks; predecessors are the CFG successors (and the exit).
+    const uint32_t n = static_cast<uint32_t>(cfg.BlockCount());
+    const uint32_t exit = n;
+    std::vector<uint32_t> exits;
+    for (uint32_t v = 0; v < n; ++v) {
+        if (cfg.succOffsets[v] == cfg.succOffsets[v + 1]) exits.push_back(v);
+    }
+
+    std::vector<uint32_t> succOffsets(cfg.predOffsets);
+    std::vector<uint32_t> succs(cfg.preds);
+    succs.insert(succs.end(), exits.begin(), exits.end());
+    succOffsets.push_back(static_cast<uint32_t>(succs.size()));
+
+    std::vector<uint32_t> predOffsets;
+    std::vector<uint32_t> preds;
+    predOffsets.reserve(n + 2);
+    preds.reserve(cfg.succs.size() + exits.size());
+    predOffsets.push_back(0);
+    for (uint32_t v = 0; v < n; ++v) {
+        preds.insert(preds.end(), cfg.succs.begin() + cfg.succOffsets[v],
+                     cfg.succs.begin() + cfg.succOffsets[v + 1]);
+        if (cfg.succOffsets[v] == cfg.succOffsets[v + 1]) preds.push_back(exit);
+        predOffsets.push_back(static_cast<uint32_t>(preds.size()));
+    }
+    predOffsets.push_back(static_cast<uint32_t>(preds.size()));
+
+    const std::vector<uint32_t> order =
+        ReversePostorder(succOffsets, succs, exit);
+    std::vector<uint32_t> orderIndex(n + 1, kNoBlock);
+    for (size_t k = 0; k < order.size(); ++k) {
+        orderIndex[order[k]] = static_cast<uint32_t>(k);
+    }
+    return IterateDominators(order, orderIndex, predOffsets, preds);
+}
+
+DominatorTree BuildDominatorTree(const std::vector<uint32_t>& idom,
+                                 uint32_t root) {
+    const size_t n = idom.size();
+    DominatorTree tree;
+    tree.parent = idom;
+    tree.depth.assign(n, 0);
+    tree.pre.assign(n, kNoBlock);
+    tree.post.assign(n, kNoBlock);
+    if (root >= n) return tree;
+
+    std::vector<uint32_t> childOffsets(n + 1, 0);
+    for (uint32_t p : idom) {
+        if (p != kNoBlock) ++childOffsets[p + 1];
+    }
+    for (size_t v = 0; v < n; ++v) childOffsets[v + 1] += childOffsets[v];
+    std::vector<uint32_t> children(childOffsets.back());
+    std::vector<uint32_t> fill(childOffsets.begin(), childOffsets.end() - 1);
+    for (size_t v = 0; v < n; ++v) {
+        if (idom[v] != kNoBlock) {
+            children[fill[idom[v]]++] = static_cast<uint32_t>(v);
+        }
+    }
+
+    uint32_t preCounter = 0;
+    uint32_t postCounter = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.emplace_back(root, childOffsets[root]);
+    tree.pre[root] = preCounter++;
+    while (!stack.empty()) {
+        const uint32_t v = stack.back().first;
+        uint32_t& e = stack.back().second;
+        if (e < childOffsets[v + 1]) {
+            const uint32_t w = children[e++];
+            tree.pre[w] = preCounter++;
+            tree.depth[w] = tree.depth[v] + 1;
+            stack.emplace_back(w, childOffsets[w]);
+            continue;
+        }
+        tree.post[v] = postCounter++;
+        stack.pop_back();
+    }
+    return tree;
+}
+
+uint32_t DominatorTree::Lca(uint32_t a, uint32_t b) const {
+    if (!Contains(a) || !Contains(b)) return kNoBlock;
+    while (depth[a] > depth[b]) a = parent[a];
+    while (depth[b] > depth[a]) b = parent[b];
+    while (a != b) {
+        a = parent[a];
+        b = parent[b];
+    }
+    return a;
+}
+
+CfgMetrics AnalyzeCfg(const FunctionCfg& cfg) {
+    CfgMetrics m;
+    const size_t n = cfg.BlockCount();
+    m.blockCount = static_cast<uint32_t>(n);
+    m.edgeCount = static_cast<uint32_t>(cfg.EdgeCount());
+    m.cyclomaticComplexity = cfg.CyclomaticComplexity();
+    m.loopDepth.assign(n, 0);
+    if (cfg.rpo.empty()) return m;
+
+    const std::vector<uint32_t> idom = ComputeDominators(cfg);
+    auto dominates = [&](uint32_t a, uint32_t b) {
+        for (uint32_t v = b; v != kNoBlock; v = idom[v]) {
+            if (v == a) return true;
+        }
+        return false;
+    };
+
+    // Classify retreating edges and take the longest acyclic path in
+    // one pass: RPO is a topological order once they are cut.
+    std::map<uint32_t, std::vector<uint32_t>> latches;
+    std::vector<uint32_t> pathLength(n, 0);
+    pathLength[cfg.rpo.front()] = 1;
+    for (uint32_t u : cfg.rpo) {
+        for (uint32_t e = cfg.succOffsets[u]; e < cfg.succOffsets[u + 1]; ++e) {
+            const uint32_t w = cfg.succs[e];
+            if (cfg.rpoIndex[w] > cfg.rpoIndex[u]) {
+                pathLength[w] = std::max(pathLength[w], pathLength[u] + 1);
+                continue;
+            }
+            ++m.backEdges;
+            if (dominates(w, u)) {
+                latches[w].push_back(u);
+            } else {
+                m.reducible = false;
+            }
+        }
+        m.longestPath = std::max(m.longestPath, pathLength[u]);
+    }
+
+    // Natural loop bodies: walk predecessors back from the latches,
+    // stopping at the header. mark[] is stamped with the header so it
+    // never needs clearing between loops.
+    std::vector<uint32_t> mark(n, kNoBlock);
+    std::vector<uint32_t> work;
+    for (const auto& [header, tails] : latches) {
+        uint32_t size = 1;
+        mark[header] = header;
+        ++m.loopDepth[header];
+        for (uint32_t tail : tails) {
+            if (mark[tail] == header) continue;
+            mark[tail] = header;
+            ++m.loopDepth[tail];
+            ++size;
+            work.push_back(tail);
+        }
+        while (!work.empty()) {
+            const uint32_t v = work.back();
+            work.pop_back();
+            for (uint32_t e = cfg.predOffsets[v]; e < cfg.predOffsets[v + 1];
+                 ++e) {
+                const uint32_t p = cfg.preds[e];
+                if (cfg.rpoIndex[p] == kNoBlock || mark[p] == header) continue;
+                mark[p] = header;
+                ++m.loopDepth[p];
+                ++size;
+                work.push_back(p);
+            }
+        }
+        m.loopHeaders.push_back(header);
+        m.loopSizes.push_back(size);
+    }
+    m.loopCount = static_cast<uint32_t>(latches.size());
+    for (uint32_t depth : m.loopDepth) {
+        m.maxLoopDepth = std::max(m.maxLoopDepth, depth);
+    }
+    return m;
+}
+
+sol::table FunctionCfgAnalytics(sol::this_state ts, Function& func) {
+    sol::state_view lua(ts);
+    const FunctionCfg cfg = BuildFunctionCfg(func);
+    const CfgMetrics m = AnalyzeCfg(cfg);
+
+    sol::table result = lua.create_table(0, 10);
+    result["block_count"] = m.blockCount;
+    result["edge_count"] = m.edgeCount;
+    result["cyclomatic_complexity"] = m.cyclomaticComplexity;
+    result["back_edges"] = m.backEdges;
+    result["loop_count"] = m.loopCount;
+    result["max_loop_depth"] = m.maxLoopDepth;
+    result["reducible"] = m.reducible;
+    result["longest_path"] = m.longestPath;
+
+    const size_t n = cfg.BlockCount();
+    std::vector<uint32_t> inDegree(n), outDegree(n);
+    for (size_t i = 0; i < n; ++i) {
+        inDegree[i] = cfg.predOffsets[i + 1] - cfg.predOffsets[i];
+        outDegree[i] = cfg.succOffsets[i + 1] - cfg.succOffsets[i];
+    }
+    sol::table blocks = lua.create_table(0, 5);
+    blocks["start"] = ColumnToTable(lua, cfg.starts);
+    blocks["end"] = ColumnToTable(lua, cfg.ends);
+    blocks["in_degree"] = ColumnToTable(lua, inDegree);
+    blocks["out_degree"] = ColumnToTable(lua, outDegree);
+    blocks["loop_depth"] = ColumnToTable(lua, m.loopDepth);
+    result["blocks"] = blocks;
+
+    sol::table loops = lua.create_table(static_cast<int>(m.loopCount), 0);
+    for (size_t i = 0; i < m.loopHeaders.size(); ++i) {
+        sol::table loop = lua.create_table(0, 2);
+        loop["header"] = static_cast<lua_Integer>(cfg.starts[m.loopHeaders[i]]);
+        loop["size"] = m.loopSizes[i];
+        loops[i + 1] = loop;
+    }
+    result["loops"] = loops;
+    return result;
+}
+
+sol::table BinaryViewCfgAnalytics(sol::this_state ts, BinaryView& bv) {
+    sol::state_view lua(ts);
+    std::shared_ptr<ViewIndex> index = GetViewIndex(bv);
+    std::lock_guard<std::mutex> lock(index->Mutex());
+    FunctionSliceCache<CfgMetrics>& cache = index->cfgMetrics;
+    cache.Refresh(*index, bv, ScanFunctionCfg);
+
+    const int n = static_cast<int>(cache.functions.size());
+    sol::table func = lua.create_table(n, 0);
+    sol::table start = lua.create_table(n, 0);
+    sol::table blockCount = lua.create_table(n, 0);
+    sol::table edgeCount = lua.create_table(n, 0);
+    sol::table cyclomatic = lua.create_table(n, 0);
+    sol::table backEdges = lua.create_table(n, 0);
+    sol::table loopCount = lua.create_table(n, 0);
+    sol::table maxLoopDepth = lua.create_table(n, 0);
+    sol::table reducible = lua.create_table(n, 0);
+    sol::table longestPath = lua.create_table(n, 0);
+    for (int i = 0; i < n; ++i) {
+        const Ref<Function>& f = cache.functions[i];
+        const CfgMetrics* m = cache.Find(f->GetObject());
+        if (!m) continue;
+        func[i + 1] = f;
+        start[i + 1] = static_cast<lua_Integer>(f->GetStart());
+        blockCount[i + 1] = m->blockCount;
+        edgeCount[i + 1] = m->edgeCount;
+        cyclomatic[i + 1] = m->cyclomaticComplexity;
+        backEdges[i + 1] = m->backEdges;
+        loopCount[i + 1] = m->loopCount;
+        maxLoopDepth[i + 1] = m->maxLoopDepth;
+        reducible[i + 1] = m->reducible;
+        longestPath[i + 1] = m->longestPath;
+    }
+
+    sol::table result = lua.create_table(0, 11);
+    result["count"] = n;
+    result["func"] = func;
+    result["start"] = start;
+    result["block_count"] = blockCount;
+    result["edge_count"] = edgeCount;
+    result["cyclomatic_complexity"] = cyclomatic;
+    result["back_edges"] = backEdges;
+    result["loop_count"] = loopCount;
+    result["max_loop_depth"] = maxLoopDepth;
+    result["reducible"] = reducible;
+    result["longest_path"] = longestPath;
+    return result;
+}
+
+std::shared_ptr<FunctionDominance> FunctionDominanceIndex(Function& func) {
+    auto dom = std::make_shared<FunctionDominance>();
+    dom->cfg = BuildFunctionCfg(func);
+    IndexBlockStarts(dom->cfg);
+    const FunctionCfg& cfg = dom->cfg;
+    dom->dominators = BuildDominatorTree(ComputeDominators(cfg), cfg.entry);
+    dom->postDominators = BuildDominatorTree(
+        ComputePostDominators(cfg), static_cast<uint32_t>(cfg.BlockCount()));
+    return dom;
+}
+
+std::shared_ptr<FunctionCfg> FunctionCfgSnapshot(Function& func) {
+    auto cfg = std::make_shared<FunctionCfg>(BuildFunctionCfg(func));
+    IndexBlockStarts(*cfg);
+    return cfg;
+}
+
+void RegisterCfgBindings(sol::state_view lua, Ref<Logger> logger) {
+    if (logger) logger->LogDebug("Registering CFG bindings");
+
+    // ControlFlowGraph node arguments and results are 1-based block
+    // indices in blocks() order; 0 or out-of-range indices yield nil /
+    // empty results.
+    auto node = [](const FunctionCfg& g, size_t i) -> std::optional<uint32_t> {
+        if (i == 0 || i > g.BlockCount()) return std::nullopt;
+        return static_cast<uint32_t>(i - 1);
+    };
+    auto indices = [](sol::this_state ts, const std::vector<uint32_t>& items) {
+        return ToLuaTable(ts, items,
+                          [](uint32_t v) -> size_t { return v + 1; });
+    };
+    auto range = [node, indices](sol::this_state ts, const FunctionCfg& g,
+                                 size_t i,
+                                 const std::vector<uint32_t>& offsets,
+                                 const std::vector<uint32_t>& adj) -> sol::table {
+        auto n = node(g, i);
+        if (!n) return sol::state_view(ts).create_table();
+        return indices(ts, std::vector<uint32_t>(adj.begin() + offsets[*n],
+                                                 adj.begin() + offsets[*n + 1]));
+    };
+    // Traversal root: the given block, or the entry when omitted.
+    auto root = [node](const FunctionCfg& g, sol::optional<size_t> i)
+        -> std::optional<uint32_t> {
+        if (i) return node(g, *i);
+        if (g.entry == kNoBlock) return std::nullopt;
+        return g.entry;
+    };
+
+    lua.new_usertype<FunctionCfg>(CONTROLFLOWGRAPH_METATABLE,
+        sol::no_constructor,
+
+        "block_count", sol::property(&FunctionCfg::BlockCount),
+        "edge_count", sol::property(&FunctionCfg::EdgeCount),
+        "entry", sol::property([](const FunctionCfg& g) -> std::optional<size_t> {
+            if (g.entry == kNoBlock) return std::nullopt;
+            return g.entry + 1;
+        }),
+
+        "blocks", [](sol::this_state ts, const FunctionCfg& g) -> sol::table {
+            return ToLuaTable(ts, g.blocks);
+        },
+
+        "block", [node](const FunctionCfg& g, size_t i) -> Ref<BasicBlock> {
+            auto n = node(g, i);
+            return n ? g.blocks[*n] : nullptr;
+        },
+
+        "index_of", [](const FunctionCfg& g, BasicBlock& b)
+            -> std::optional<size_t> {
+            const uint32_t v = g.IndexOf(b);
+            if (v == kNoBlock) return std::nullopt;
+            return static_cast<size_t>(v) + 1;
+        },
+
+        "starts", [](sol::this_state ts, const FunctionCfg& g) -> sol::table {
+            return ToLuaTable(ts, g.starts,
+                              [](uint64_t a) { return static_cast<lua_Integer>(a); });
+        },
+
+        "ends", [](sol::this_state ts, const FunctionCfg& g) -> sol::table {
+            return ToLuaTable(ts, g.ends,
+                              [](uint64_t a) { return static_cast<lua_Integer>(a); });
+        },
+
+        "successors", [range](sol::this_state ts, const FunctionCfg& g,
+                              size_t i) -> sol::table {
+            return range(ts, g, i, g.succOffsets, g.succs);
+        },
+
+        "predecessors", [range](sol::this_state ts, const FunctionCfg& g,
+                                size_t i) -> sol::table {
+            return range(ts, g, i, g.predOffsets, g.preds);
+        },
+
+        // Branch type names of the successor edges, parallel to
+        // successors(i).
+        "successor_types", [node](sol::this_state ts, const FunctionCfg& g,
+                                  size_t i) -> sol::table {
+            sol::state_view lua(ts);
+            auto n = node(g, i);
+            if (!n) return lua.create_table();
+            const uint32_t first = g.succOffsets[*n];
+            const uint32_t last = g.succOffsets[*n + 1];
+            sol::table result = lua.create_table(static_cast<int>(last - first), 0);
+            for (uint32_t e = first; e < last; ++e) {
+                result[e - first + 1] =
+                    EnumToString(static_cast<BNBranchType>(g.edgeTypes[e]));
+            }
+            return result;
+        },
+
+        "out_degree", [node](const FunctionCfg& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.succOffsets[*n + 1] - g.succOffsets[*n] : 0;
+        },
+
+        "in_degree", [node](const FunctionCfg& g, size_t i) -> size_t {
+            auto n = node(g, i);
+            return n ? g.predOffsets[*n + 1] - g.predOffsets[*n] : 0;
+        },
+
+        "bfs", [root, indices](sol::this_state ts, const FunctionCfg& g,
+                               sol::optional<size_t> start) -> sol::table {
+            auto r = root(g, start);
+            if (!r) return sol::state_view(ts).create_table();
+            return indices(ts, BreadthFirstOrder(g, *r));
+        },
+
+        "dfs", [root, indices](sol::this_state ts, const FunctionCfg& g,
+                               sol::optional<size_t> start) -> sol::table {
+            auto r = root(g, start);
+            if (!r) return sol::state_view(ts).create_table();
+            return indices(ts, DepthFirstPreorder(g, *r));
+        },
+
+        "reverse_postorder", [indices](sol::this_state ts,
+                                       const FunctionCfg& g) -> sol::table {
+            return indices(ts, g.rpo);
+        },
+
+        // Flat export. Successors of block i are
+        // succs[succ_offsets[i] .. succ_offsets[i + 1] - 1] (likewise for
+        // preds); offsets and block indices are 1-based, edge_types
+        // holds BNBranchType codes named by type_names.
+        "csr", [](sol::this_state ts, const FunctionCfg& g) -> sol::table {
+            sol::state_view lua(ts);
+            auto plusOne = [](uint32_t v) -> size_t { return v + 1; };
+            auto address = [](uint64_t a) { return static_cast<lua_Integer>(a); };
+            sol::table typeNames = lua.create_table();
+            for (uint8_t code : g.edgeTypes) {
+                typeNames[code] = EnumToString(static_cast<BNBranchType>(code));
+            }
+            sol::table result = lua.create_table(0, 10);
+            result["block_count"] = g.BlockCount();
+            result["edge_count"] = g.EdgeCount();
+            result["start"] = ToLuaTable(ts, g.starts, address);
+            result["end"] = ToLuaTable(ts, g.ends, address);
+            result["succ_offsets"] = ToLuaTable(ts, g.succOffsets, plusOne);
+            result["succs"] = ToLuaTable(ts, g.succs, plusOne);
+            result["edge_types"] = ToLuaTable(ts, g.edgeTypes,
+                [](uint8_t code) -> int { return code; });
+            result["pred_offsets"] = ToLuaTable(ts, g.predOffsets, plusOne);
+            result["preds"] = ToLuaTable(ts, g.preds, plusOne);
+            result["type_names"] = typeNames;
+            return result;
+        },
+
+        sol::meta_function::to_string, [](const FunctionCfg& g) -> std::string {
+            return fmt::format("<ControlFlowGraph: {} blocks, {} edges>",
+                               g.BlockCount(), g.EdgeCount());
+        }
+    );
+
+    // Block arguments are BasicBlock userdata or 1-based block indices
+    // (the order of blocks() and the tree() arrays); anything else
+    // resolves to no block.
+    auto block = [](const FunctionDominance& d,
+                    sol::object value) -> uint32_t {
+        const size_t n = d.cfg.BlockCount();
+        if (value.is<BasicBlock>()) {
+            return d.cfg.IndexOf(value.as<BasicBlock&>());
+        }
+        if (value.get_type() == sol::type::number) {
+            const lua_Integer i = value.as<lua_Integer>();
+            if (i >= 1 && static_cast<size_t>(i) <= n) {
+                return static_cast<uint32_t>(i - 1);
+            }
+        }
+        return kNoBlock;
+    };
+    // Tree nodes past the last block (the virtual exit) map to nil.
+    auto blockRef = [](const FunctionDominance& d,
+                       uint32_t v) -> Ref<BasicBlock> {
+        return v < d.cfg.BlockCount() ? d.cfg.blocks[v] : nullptr;
+    };
+
+    lua.new_usertype<FunctionDominance>(DOMINANCE_METATABLE,
+        sol::no_constructor,
+
+        "block_count", sol::property([](const FunctionDominance& d) -> size_t {
+            return d.cfg.BlockCount();
+        }),
+
+        "blocks", [](sol::this_state ts, const FunctionDominance& d) -> sol::table {
+            return ToLuaTable(ts, d.cfg.blocks);
+        },
+
+        "index_of", [block](const FunctionDominance& d, sol::object b)
+            -> std::optional<size_t> {
+            const uint32_t v = block(d, b);
+            if (v == kNoBlock) return std::nullopt;
+            return v + 1;
+        },
+
+        "dominates", [block](const FunctionDominance& d, sol::object a,
+                             sol::object b) -> bool {
+            return d.dominators.Dominates(block(d, a), block(d, b));
+        },
+
+        "post_dominates", [block](const FunctionDominance& d, sol::object a,
+                                  sol::object b) -> bool {
+            return d.postDominators.Dominates(block(d, a), block(d, b));
+        },
+
+        "idom", [block, blockRef](const FunctionDominance& d, sol::object a)
+            -> Ref<BasicBlock> {
+            const uint32_t v = block(d, a);
+            if (v == kNoBlock) return nullptr;
+            return blockRef(d, d.dominators.parent[v]);
+        },
+
+        "ipdom", [block, blockRef](const FunctionDominance& d, sol::object a)
+            -> Ref<BasicBlock> {
+            const uint32_t v = block(d, a);
+            if (v == kNoBlock) return nullptr;
+            return blockRef(d, d.postDominators.parent[v]);
+        },
+
+        "lca", [block, blockRef](const FunctionDominance& d, sol::object a,
+                                 sol::object b) -> Ref<BasicBlock> {
+            return blockRef(d, d.dominators.Lca(block(d, a), block(d, b)));
+        },
+
+        "post_lca", [block, blockRef](const FunctionDominance& d,
+                                      sol::object a, sol::object b)
+            -> Ref<BasicBlock> {
+            return blockRef(d, d.postDominators.Lca(block(d, a), block(d, b)));
+        },
+
+        // Bulk export: parallel arrays over blocks() order. idom / ipdom
+        // are 1-based parent indices, 0 for tree roots and for blocks
+        // outside the tree (unreachable / no path to an exit).
+        "tree", [](sol::this_state ts, const FunctionDominance& d) -> sol::table {
+            sol::state_view lua(ts);
+            const size_t n = d.cfg.BlockCount();
+            const int size = static_cast<int>(n);
+            sol::table start = lua.create_table(size, 0);
+            sol::table idom = lua.create_table(size, 0);
+            sol::table ipdom = lua.create_table(size, 0);
+            sol::table depth = lua.create_table(size, 0);
+            auto parentIndex = [n](uint32_t p) -> size_t {
+                return p < n ? p + 1 : 0;
+            };
+            for (size_t i = 0; i < n; ++i) {
+                start[i + 1] = static_cast<lua_Integer>(d.cfg.starts[i]);
+                idom[i + 1] = parentIndex(d.dominators.parent[i]);
+                ipdom[i + 1] = parentIndex(d.postDominators.parent[i]);
+                depth[i + 1] = d.dominators.depth[i];
+            }
+            sol::table result = lua.create_table(0, 5);
+            result["count"] = n;
+            result["start"] = start;
+            result["idom"] = idom;
+            result["ipdom"] = ipdom;
+            result["depth"] = depth;
+            return result;
+        },
+
+        sol::meta_function::to_string, [](const FunctionDominance& d) -> std::string {
+            return fmt::format("<Dominance: {} blocks>", d.cfg.BlockCount());
+        }
+    );
+
+    if (logger) logger->LogDebug("CFG bindings registered");
+}
+
+}  // namespace BinjaLua
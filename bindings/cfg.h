@@ -0,0 +1,138 @@
+// Native control-flow graph snapshots for binja-lua.
+//
+// A FunctionCfg copies a function's native basic blocks into CSR
+// arrays once, so graph algorithms (loop analysis, dominators, ...)
+// run over plain integers instead of per-edge Ref<BasicBlock> lists.
+// Blocks are numbered by their position in Function::GetBasicBlocks();
+// the entry block is the one starting at the function start.
+//
+// Builders only make core calls and are safe on ParallelFor workers.
+
+#pragma once
+
+#include "common.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace BinjaLua {
+
+constexpr uint32_t kNoBlock = std::numeric_limits<uint32_t>::max();
+
+struct FunctionCfg {
+    Ref<Function> func;
+    std::vector<Ref<BasicBlock>> blocks;
+    std::vector<uint64_t> starts;
+    std::vector<uint64_t> ends;
+    uint32_t entry = kNoBlock;
+    // Successors of block i: succs[succOffsets[i] .. succOffsets[i+1]),
+    // with the BNBranchType of each edge in edgeTypes. Edges whose
+    // target is not a block of this function are dropped.
+    std::vector<uint32_t> succOffsets;
+    std::vector<uint32_t> succs;
+    std::vector<uint8_t> edgeTypes;
+    // Predecessors, same layout.
+    std::vector<uint32_t> predOffsets;
+    std::vector<uint32_t> preds;
+    // Blocks reachable from the entry in DFS reverse postorder, and
+    // each block's position in it (kNoBlock when unreachable). An edge
+    // u -> v between reachable blocks is retreating iff
+    // rpoIndex[v] <= rpoIndex[u].
+    std::vector<uint32_t> rpo;
+    std::vector<uint32_t> rpoIndex;
+    // Native block start -> block, filled by IndexBlockStarts for the
+    // snapshots that resolve BasicBlock arguments (func:cfg(),
+    // func:dominance()).
+    std::unordered_map<uint64_t, uint32_t> blockAt;
+
+    size_t BlockCount() const { return blocks.size(); }
+    size_t EdgeCount() const { return succs.size(); }
+    // E - N + 2 over the kept edges; the one definition behind both
+    // func:cfg_analytics() and func:summary().
+    int64_t CyclomaticComplexity() const {
+        return static_cast<int64_t>(EdgeCount()) -
+               static_cast<int64_t>(BlockCount()) + 2;
+    }
+    // Block index of a native block of func, kNoBlock for IL blocks,
+    // blocks of other functions and unknown starts. Needs blockAt.
+    uint32_t IndexOf(BasicBlock& block) const;
+};
+
+FunctionCfg BuildFunctionCfg(Function& func);
+void IndexBlockStarts(FunctionCfg& cfg);
+
+// Immediate dominator of every block (Cooper / Harvey / Kennedy over
+// the reverse postorder); kNoBlock for the entry and for unreachable
+// blocks.
+std::vector<uint32_t> ComputeDominators(const FunctionCfg& cfg);
+
+// Loop and shape metrics for one function. Loops are natural loops of
+// back edges whose target dominates their source, merged per header;
+// retreating edges that are not back edges make the graph irreducible.
+struct CfgMetrics {
+    uint32_t blockCount = 0;
+    uint32_t edgeCount = 0;
+    int64_t cyclomaticComplexity = 0;  // E - N + 2
+    uint32_t backEdges = 0;            // retreating DFS edges
+    uint32_t loopCount = 0;
+    uint32_t maxLoopDepth = 0;
+    bool reducible = true;
+    // Blocks on the longest entry path once retreating edges are cut.
+    uint32_t longestPath = 0;
+    // Per block: number of natural loops containing it.
+    std::vector<uint32_t> loopDepth;
+    // Per loop (ascending header): header block and body size.
+    std::vector<uint32_t> loopHeaders;
+    std::vector<uint32_t> loopSizes;
+};
+
+CfgMetrics AnalyzeCfg(const FunctionCfg& cfg);
+
+// Immediate post-dominators over blocks plus a virtual exit node
+// (index BlockCount()) that every block without successors flows
+// into. kNoBlock for the virtual exit and for blocks that cannot
+// reach an exit.
+std::vector<uint32_t> ComputePostDominators(const FunctionCfg& cfg);
+
+// Dominator tree with DFS pre / post numbering, so dominance is an
+// interval test. Nodes outside the tree (unreachable blocks) have
+// pre == kNoBlock.
+struct DominatorTree {
+    std::vector<uint32_t> parent;  // kNoBlock for the root
+    std::vector<uint32_t> depth;
+    std::vector<uint32_t> pre;
+    std::vector<uint32_t> post;
+
+    bool Contains(uint32_t v) const {
+        return v < pre.size() && pre[v] != kNoBlock;
+    }
+    // Reflexive: every node in the tree dominates itself.
+    bool Dominates(uint32_t a, uint32_t b) const {
+        return Contains(a) && Contains(b) && pre[a] <= pre[b] &&
+               post[b] <= post[a];
+    }
+    // Nearest common ancestor, kNoBlock when either is outside.
+    uint32_t Lca(uint32_t a, uint32_t b) const;
+};
+
+DominatorTree BuildDominatorTree(const std::vector<uint32_t>& idom,
+                                 uint32_t root);
+
+// Per-function dominance snapshot behind func:dominance().
+struct FunctionDominance {
+    FunctionCfg cfg;
+    DominatorTree dominators;
+    // Rooted at the virtual exit node (index cfg.BlockCount()).
+    DominatorTree postDominators;
+};
+
+// Lua-facing queries.
+sol::table FunctionCfgAnalytics(sol::this_state ts, Function& func);
+sol::table BinaryViewCfgAnalytics(sol::this_state ts, BinaryView& bv);
+std::shared_ptr<FunctionDominance> FunctionDominanceIndex(Function& func);
+std::shared_ptr<FunctionCfg> FunctionCfgSnapshot(Function& func);
+
+}  // namespace BinjaLua
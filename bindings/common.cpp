@@ -69,6 +69,11 @@ void RegisterAllBindings(lua_State* L, Ref<Logger> logger) {
     RegisterVariableBindings(lua, logger);
     RegisterDataVariableBindings(lua, logger);
 
+    // 3a. Analysis-index result types (CallGraph, ControlFlowGraph,
+    // Dominance); Function and BinaryView methods return them.
+    RegisterAnalysisIndexBindings(lua, logger);
+    RegisterCfgBindings(lua, logger);
+
     // 4. Complex types that use all others
     RegisterFunctionBindings(lua, logger);
     RegisterBinaryViewBindings(lua, logger);
@@ -87,6 +92,9 @@ void RegisterAllBindings(lua_State* L, Ref<Logger> logger) {
     // HLILInstruction.mlil returns a MediumLevelILInstruction
     // value-usertype (HLIL -> MLIL cross-reference). R9.3 addition.
     RegisterHLILInstructionBindings(lua, logger);
+    // Compiled IL tree patterns; matches return MLIL / HLIL
+    // instruction usertypes.
+    RegisterILPatternBindings(lua, logger);
 
     // 6. Type system
     RegisterTypeBindings(lua, logger);
@@ -38,6 +38,11 @@ constexpr const char* CALLINGCONVENTION_METATABLE =
     "BinaryNinja.CallingConvention";
 constexpr const char* PLATFORM_METATABLE = "BinaryNinja.Platform";
 constexpr const char* SETTINGS_METATABLE = "BinaryNinja.Settings";
+constexpr const char* CALLGRAPH_METATABLE = "BinaryNinja.CallGraph";
+constexpr const char* DOMINANCE_METATABLE = "BinaryNinja.Dominance";
+constexpr const char* CONTROLFLOWGRAPH_METATABLE =
+    "BinaryNinja.ControlFlowGraph";
+constexpr const char* ILPATTERN_METATABLE = "BinaryNinja.ILPattern";
 
 // Logger key for storing in Lua registry
 constexpr const char* LOGGER_REGISTRY_KEY = "__binja_logger";
@@ -84,6 +89,9 @@ void RegisterCallingConventionBindings(sol::state_view lua,
                                         Ref<Logger> logger);
 void RegisterPlatformBindings(sol::state_view lua, Ref<Logger> logger);
 void RegisterSettingsBindings(sol::state_view lua, Ref<Logger> logger);
+void RegisterAnalysisIndexBindings(sol::state_view lua, Ref<Logger> logger);
+void RegisterCfgBindings(sol::state_view lua, Ref<Logger> logger);
+void RegisterILPatternBindings(sol::state_view lua, Ref<Logger> logger);
 void RegisterGlobalFunctions(sol::state_view lua, Ref<Logger> logger);
 
 // Load optional Lua API extensions (lua-api/*.lua)
@@ -1,11 +1,72 @@
 // Sol2 Function bindings for binja-lua
 
 #include "common.h"
+#include "analysis_index.h"
+#include "cfg.h"
 #include <set>
 #include <cmath>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <tuple>
 
 namespace BinjaLua {
 
+namespace {
+
+// Streaming state behind func:iter_disassembly(). Blocks are visited in
+// start order and their disassembly is fetched only once the merge
+// reaches them; lines of the fetched blocks are merged by address
+// through a min-heap, so the function is never materialized or sorted
+// as a whole.
+struct DisassemblyStream {
+    enum class Mode { Instruction, Text, Mnemonic };
+
+    struct Cursor {
+        std::vector<DisassemblyTextLine> lines;
+        size_t pos = 0;
+    };
+
+    Mode mode = Mode::Instruction;
+    Ref<BinaryView> view;
+    Ref<Architecture> arch;
+    Ref<DisassemblySettings> settings;
+    std::vector<Ref<BasicBlock>> blocks;  // ascending start
+    size_t nextBlock = 0;
+    std::vector<Cursor> cursors;
+    // (next line address, cursor index)
+    std::priority_queue<std::pair<uint64_t, size_t>,
+                        std::vector<std::pair<uint64_t, size_t>>,
+                        std::greater<>> heap;
+
+    std::optional<DisassemblyTextLine> Next() {
+        // A block that has not been fetched yet starts after the heap
+        // minimum, so none of its lines can come first.
+        while (nextBlock < blocks.size() &&
+               (heap.empty() || blocks[nextBlock]->GetStart() <= heap.top().first)) {
+            Cursor cursor;
+            cursor.lines = blocks[nextBlock++]->GetDisassemblyText(settings);
+            if (cursor.lines.empty()) continue;
+            cursors.push_back(std::move(cursor));
+            heap.emplace(cursors.back().lines.front().addr, cursors.size() - 1);
+        }
+        if (heap.empty()) return std::nullopt;
+
+        const size_t c = heap.top().second;
+        heap.pop();
+        Cursor& cursor = cursors[c];
+        DisassemblyTextLine line = std::move(cursor.lines[cursor.pos++]);
+        if (cursor.pos < cursor.lines.size()) {
+            heap.emplace(cursor.lines[cursor.pos].addr, c);
+        } else {
+            cursor.lines = {};
+        }
+        return line;
+    }
+};
+
+}  // namespace
+
 void RegisterFunctionBindings(sol::state_view lua, Ref<Logger> logger) {
     if (logger) logger->LogDebug("Registering Function bindings");
 
@@ -116,22 +177,9 @@ void RegisterFunctionBindings(sol::state_view lua, Ref<Logger> logger) {
         }),
 
         // is_thunk: true if function is a single-block tailcall thunk
+        // (cached per function version, see FunctionSummary)
         "is_thunk", sol::property([](Function& f) -> bool {
-            Ref<LowLevelILFunction> llil = f.GetLowLevelIL();
-            if (!llil) return false;
-            auto blocks = llil->GetBasicBlocks();
-            if (blocks.size() != 1) return false;
-            // Check if the single block ends with a tailcall
-            Ref<BasicBlock> block = blocks[0];
-            size_t startIdx = block->GetStart();
-            size_t endIdx = block->GetEnd();
-            if (endIdx <= startIdx) return false;
-            // Get the last instruction via BN API
-            size_t lastIdx = endIdx - 1;
-            BNLowLevelILInstruction instr = BNGetLowLevelILByIndex(
-                llil->GetObject(), lastIdx);
-            return instr.operation == LLIL_TAILCALL ||
-                   instr.operation == LLIL_TAILCALL_SSA;
+            return GetFunctionSummary(f).isThunk;
         }),
 
         // Collection methods - use method syntax: func:basic_blocks(), func:callers(), etc.
@@ -140,90 +188,46 @@ void RegisterFunctionBindings(sol::state_view lua, Ref<Logger> logger) {
             return ToLuaTable(ts, f.GetBasicBlocks());
         },
 
-        "calls", [](sol::this_state ts, Function& f) -> sol::table {
-            std::vector<ReferenceSource> call_sites = f.GetCallSites();
-            std::vector<Ref<Function>> called;
-            Ref<BinaryView> view = f.GetView();
-
-            for (const auto& site : call_sites) {
-                for (uint64_t addr : view->GetCallees(site)) {
-                    Ref<Function> fn = view->GetAnalysisFunction(f.GetPlatform(), addr);
-                    if (fn) called.push_back(fn);
-                }
-            }
-
-            return ToLuaTable(ts, called);
-        },
-
-        "callers", [](sol::this_state ts, Function& f) -> sol::table {
-            sol::state_view lua(ts);
-            Ref<BinaryView> view = f.GetView();
-            std::vector<ReferenceSource> refs = view->GetCallers(f.GetStart());
-
-            sol::table result = lua.create_table();
-            int idx = 1;
-            for (const auto& ref : refs) {
-                if (ref.func) result[idx++] = ref.func;
-            }
-            return result;
-        },
+        // Call relationships come from the per-view call graph
+        // (bindings/analysis_index.cpp). calls / callers list one
+        // entry per call site; callees / callee_addresses are unique.
+        "calls", &FunctionCalls,
+        "callers", &FunctionCallers,
 
         // Additional cross-reference methods
         "call_sites", [](sol::this_state ts, Function& f) -> sol::table {
             return ReferenceSourcesToTable(ts, f.GetCallSites());
         },
 
-        "callees", [](sol::this_state ts, Function& f) -> sol::table {
-            sol::state_view lua(ts);
-            std::vector<ReferenceSource> call_sites = f.GetCallSites();
-            Ref<BinaryView> view = f.GetView();
-            std::vector<Ref<Function>> funcs;
-            std::set<uint64_t> seenAddrs;
-
-            for (const auto& site : call_sites) {
-                for (uint64_t addr : view->GetCallees(site)) {
-                    if (seenAddrs.find(addr) == seenAddrs.end()) {
-                        Ref<Function> fn = view->GetAnalysisFunction(f.GetPlatform(), addr);
-                        if (fn) {
-                            funcs.push_back(fn);
-                            seenAddrs.insert(addr);
-                        }
-                    }
-                }
-            }
+        "callees", &FunctionCallees,
+        "callee_addresses", &FunctionCalleeAddresses,
 
-            sol::table result = lua.create_table();
-            for (size_t i = 0; i < funcs.size(); i++) {
-                result[i + 1] = funcs[i];
-            }
-            return result;
-        },
+        // Cached block / edge / instruction counts, thunk, exported,
+        // cyclomatic complexity and loop flags for this function.
+        "summary", &FunctionSummaryTable,
 
-        "callee_addresses", [](sol::this_state ts, Function& f) -> sol::table {
-            sol::state_view lua(ts);
-            std::vector<ReferenceSource> call_sites = f.GetCallSites();
-            Ref<BinaryView> view = f.GetView();
-            std::set<uint64_t> uniqueAddrs;
+        // Native loop / shape analysis of the basic-block graph, with
+        // per-block degree and loop-depth columns.
+        "cfg_analytics", &FunctionCfgAnalytics,
 
-            for (const auto& site : call_sites) {
-                for (uint64_t addr : view->GetCallees(site)) {
-                    uniqueAddrs.insert(addr);
-                }
-            }
+        // Dominator / post-dominator trees with pre/post numbering for
+        // O(1) dominates checks; a snapshot, rebuild after reanalysis.
+        "dominance", &FunctionDominanceIndex,
 
-            sol::table result = lua.create_table();
-            int idx = 1;
-            for (uint64_t addr : uniqueAddrs) {
-                result[idx++] = HexAddress(addr);
-            }
-            return result;
-        },
+        // Compact CSR form of control_flow_graph(): integer block and
+        // edge arrays behind a ControlFlowGraph userdata.
+        "cfg", &FunctionCfgSnapshot,
 
         "caller_sites", [](sol::this_state ts, Function& f) -> sol::table {
             Ref<BinaryView> view = f.GetView();
             return ReferenceSourcesToTable(ts, view->GetCallers(f.GetStart()));
         },
 
+        // Strings this function references, from the per-view string
+        // xref index (bindings/analysis_index.cpp). Entries extend the
+        // bv:strings() shape with `refs`, the referencing addresses.
+        "referenced_strings", &FunctionReferencedStrings,
+
         "variables", [](sol::this_state ts, Function& f) -> sol::table {
             sol::state_view lua(ts);
             Ref<Function> func = &f;
@@ -724,6 +728,68 @@ void RegisterFunctionBindings(sol::state_view lua, Ref<Logger> logger) {
             return result;
         },
 
+        // Streaming form of disassembly(): a generic-for iterator
+        // yielding (address, value) in address order, where value is an
+        // Instruction (default), the line text ("text") or only the
+        // mnemonic ("mnemonic"). Tokens are converted per yielded line.
+        "iter_disassembly", [](sol::this_state ts, Function& f,
+                               sol::optional<std::string> mode) -> sol::object {
+            sol::state_view lua(ts);
+            auto stream = std::make_shared<DisassemblyStream>();
+            if (mode && *mode == "text") {
+                stream->mode = DisassemblyStream::Mode::Text;
+            } else if (mode && *mode == "mnemonic") {
+                stream->mode = DisassemblyStream::Mode::Mnemonic;
+            } else if (mode && *mode != "instruction") {
+                if (Ref<Logger> logger = GetLogger(lua)) {
+                    logger->LogWarn("iter_disassembly: unknown mode '%s'",
+                                    mode->c_str());
+                }
+            }
+            stream->view = f.GetView();
+            stream->arch = f.GetArchitecture();
+            stream->settings = DisassemblySettings::GetDefaultSettings();
+            stream->blocks = f.GetBasicBlocks();
+            std::sort(stream->blocks.begin(), stream->blocks.end(),
+                [](const Ref<BasicBlock>& a, const Ref<BasicBlock>& b) {
+                    return a->GetStart() < b->GetStart();
+                });
+
+            return sol::make_object(lua, [stream](sol::this_state ts)
+                -> std::tuple<sol::object, sol::object> {
+                sol::state_view lua(ts);
+                std::optional<DisassemblyTextLine> line = stream->Next();
+                if (!line) {
+                    return {sol::make_object(lua, sol::lua_nil),
+                            sol::make_object(lua, sol::lua_nil)};
+                }
+                sol::object addr = sol::make_object(lua, HexAddress(line->addr));
+                switch (stream->mode) {
+                case DisassemblyStream::Mode::Text: {
+                    std::string text;
+                    for (const auto& token : line->tokens) text += token.text;
+                    return {addr, sol::make_object(lua, text)};
+                }
+                case DisassemblyStream::Mode::Mnemonic:
+                    for (const auto& token : line->tokens) {
+                        if (token.type == InstructionToken) {
+                            return {addr, sol::make_object(lua, token.text)};
+                        }
+                    }
+                    return {addr, sol::make_object(lua, "<unknown>")};
+                case DisassemblyStream::Mode::Instruction:
+                    break;
+                }
+                std::vector<BNInstructionTextToken> tokens;
+                tokens.reserve(line->tokens.size());
+                for (const auto& token : line->tokens) {
+                    tokens.push_back(token.GetAPIObject());
+                }
+                return {addr, sol::make_object(lua, InstructionWrapper(
+                    line->addr, tokens, stream->view, stream->arch))};
+            });
+        },
+
         // Control flow graph - use method syntax: func:control_flow_graph()
         "control_flow_graph", [](sol::this_state ts, Function& f) -> sol::table {
             sol::state_view lua(ts);
@@ -743,17 +809,7 @@ void RegisterFunctionBindings(sol::state_view lua, Ref<Logger> logger) {
                     edge["target_addr"] = HexAddress(outgoing[j].target->GetStart());
                     edge["back_edge"] = outgoing[j].backEdge;
                     edge["fall_through"] = outgoing[j].fallThrough;
-                    const char* t = "unknown";
-                    switch (outgoing[j].type) {
-                        case UnconditionalBranch: t = "unconditional"; break;
-                        case FalseBranch: t = "false"; break;
-                        case TrueBranch: t = "true"; break;
-                        case CallDestination: t = "call"; break;
-                        case FunctionReturn: t = "return"; break;
-                        case IndirectBranch: t = "indirect"; break;
-                        default: break;
-                    }
-                    edge["type"] = t;
+                    edge["type"] = EnumToString(outgoing[j].type);
                     outEdges[j + 1] = edge;
                 }
                 blockInfo["outgoing_edges"] = outEdges;
@@ -26,10 +26,196 @@
 
 #include "common.h"
 #include "il.h"
+#include "il_pattern.h"
+#include <bitset>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace BinjaLua {
 
+namespace {
+
+// Opcode membership set for the find_ops / instructions / expressions
+// filters. Every BN*ILOperation enumerator fits in a byte.
+using ILOperationSet = std::bitset<256>;
+
+// opts.ssa selects the SSA form of the IL function. Null when the
+// function has no SSA form (or already is one).
+template <typename ILFunction>
+Ref<ILFunction> ILFormFor(ILFunction& il,
+                          const sol::optional<sol::table>& opts) {
+    if (opts && opts->get_or("ssa", false)) return il.GetSSAForm();
+    return Ref<ILFunction>(&il);
+}
+
+// Parse a list of opcode names ("MLIL_CALL" or "call") into a set.
+// Unknown names are logged and skipped.
+template <typename Operation>
+ILOperationSet ParseOperationSet(sol::state_view lua, const char* caller,
+                                 const sol::table& names) {
+    ILOperationSet set;
+    for (size_t i = 1, n = names.size(); i <= n; ++i) {
+        auto name = names.raw_get<sol::optional<std::string>>(i);
+        if (!name) continue;
+        std::optional<Operation> op = EnumFromString<Operation>(*name);
+        if (!op) {
+            GetLogger(lua)->LogWarn("%s: unknown operation '%s'", caller,
+                                    name->c_str());
+            continue;
+        }
+        set.set(static_cast<size_t>(*op));
+    }
+    return set;
+}
+
+// Shared walk behind il:instructions(), il:expressions() and
+// il:find_ops(). Instructions are walked lazily and only their raw
+// opcode is read, so filtered-out entries never become instruction
+// usertypes. Expressions are the trees reachable from the
+// instructions (HLIL: from the root statement), the same walk as
+// bv:opcode_histogram and il:match; orphaned entries left in the
+// expression pool by analysis are not visited. Their indices are
+// gathered up front, since VisitExprs cannot be suspended.
+template <typename ILFunction>
+class ILCursor {
+public:
+    using Operation =
+        decltype(std::declval<ILFunction&>().GetRawExpr(0).operation);
+    using Instruction =
+        decltype(std::declval<ILFunction&>().GetInstruction(0));
+
+    ILCursor(Ref<ILFunction> il, bool expressions,
+             std::optional<ILOperationSet> filter)
+        : m_il(std::move(il)), m_expressions(expressions),
+          m_filter(std::move(filter)) {
+        if (!m_il) return;
+        if (!expressions) {
+            m_end = m_il->GetInstructionCount();
+            return;
+        }
+        auto visit = [this](const Instruction& expr) -> bool {
+            if (!m_filter ||
+                m_filter->test(static_cast<size_t>(expr.operation))) {
+                m_exprs.push_back(expr.exprIndex);
+            }
+            return true;
+        };
+        if constexpr (std::is_same_v<ILFunction, HighLevelILFunction>) {
+            m_il->GetRootExpr().VisitExprs(visit);
+        } else {
+            for (size_t i = 0, n = m_il->GetInstructionCount(); i < n; ++i) {
+                m_il->GetInstruction(i).VisitExprs(visit);
+            }
+        }
+        m_end = m_exprs.size();
+    }
+
+    // Next matching instruction (or expression) index, or false when
+    // exhausted.
+    bool Next(size_t& index) {
+        if (m_expressions) {
+            if (m_next >= m_end) return false;
+            index = m_exprs[m_next++];
+            return true;
+        }
+        while (m_next < m_end) {
+            size_t i = m_next++;
+            if (m_filter) {
+                auto op = static_cast<size_t>(
+                    m_il->GetRawExpr(m_il->GetIndexForInstruction(i)).operation);
+                if (!m_filter->test(op)) continue;
+            }
+            index = i;
+            return true;
+        }
+        return false;
+    }
+
+    sol::object Push(sol::state_view lua, size_t index) const {
+        if (m_expressions) return sol::make_object(lua, m_il->GetExpr(index));
+        return sol::make_object(lua, m_il->GetInstruction(index));
+    }
+
+private:
+    Ref<ILFunction> m_il;
+    bool m_expressions;
+    std::optional<ILOperationSet> m_filter;
+    std::vector<size_t> m_exprs;
+    size_t m_next = 0;
+    size_t m_end = 0;
+};
+
+// opts.ops, when present, restricts the walk to those opcodes.
+template <typename ILFunction>
+std::optional<ILOperationSet> FilterFromOpts(
+    sol::state_view lua, const char* caller,
+    const sol::optional<sol::table>& opts) {
+    if (!opts) return std::nullopt;
+    sol::optional<sol::table> ops = opts->get<sol::optional<sol::table>>("ops");
+    if (!ops) return std::nullopt;
+    return ParseOperationSet<typename ILCursor<ILFunction>::Operation>(
+        lua, caller, *ops);
+}
+
+template <typename ILFunction>
+sol::object ILIterator(sol::state_view lua, const char* caller,
+                       ILFunction& il, bool expressions,
+                       const sol::optional<sol::table>& opts) {
+    auto cursor = std::make_shared<ILCursor<ILFunction>>(
+        ILFormFor(il, opts), expressions,
+        FilterFromOpts<ILFunction>(lua, caller, opts));
+    return sol::make_object(lua, [cursor](sol::this_state ts) -> sol::object {
+        sol::state_view lua(ts);
+        size_t index = 0;
+        if (!cursor->Next(index)) {
+            return sol::make_object(lua, sol::lua_nil_t{});
+        }
+        return cursor->Push(lua, index);
+    });
+}
+
+// il:instructions([opts]) -> iterator over top-level instructions.
+template <typename ILFunction>
+sol::object ILInstructions(sol::this_state ts, ILFunction& il,
+                           sol::optional<sol::table> opts) {
+    return ILIterator(sol::state_view(ts), "instructions", il, false, opts);
+}
+
+// il:expressions([opts]) -> iterator over every expression reachable
+// from the function's instructions, nested ones included, in pre-order.
+template <typename ILFunction>
+sol::object ILExpressions(sol::this_state ts, ILFunction& il,
+                          sol::optional<sol::table> opts) {
+    return ILIterator(sol::state_view(ts), "expressions", il, true, opts);
+}
+
+// il:find_ops(ops [, opts]) -> array of matching instruction
+// usertypes. Searches every expression unless opts.expressions is
+// false, in which case only top-level instructions are considered.
+template <typename ILFunction>
+sol::table ILFindOps(sol::this_state ts, ILFunction& il, sol::table ops,
+                     sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    sol::table out = lua.create_table();
+    bool expressions = opts ? opts->get_or("expressions", true) : true;
+    ILCursor<ILFunction> cursor(
+        ILFormFor(il, opts), expressions,
+        ParseOperationSet<typename ILCursor<ILFunction>::Operation>(
+            lua, "find_ops", ops));
+    size_t index = 0;
+    int i = 1;
+    while (cursor.Next(index)) {
+        out.raw_set(i++, cursor.Push(lua, index));
+    }
+    return out;
+}
+
+}  // namespace
+
 void RegisterILBindings(sol::state_view lua, Ref<Logger> logger) {
     if (logger) logger->LogDebug("Registering IL bindings");
 
@@ -65,6 +251,12 @@ void RegisterILBindings(sol::state_view lua, Ref<Logger> logger) {
             return sol::make_object(lua, il[index]);
         },
 
+        // Native walks: iterators over instructions / expressions
+        // and an opcode filter, all optionally over the SSA form.
+        "instructions", &ILInstructions<LowLevelILFunction>,
+        "expressions", &ILExpressions<LowLevelILFunction>,
+        "find_ops", &ILFindOps<LowLevelILFunction>,
+
         "get_text", [](LowLevelILFunction& il, size_t index) -> std::string {
             if (index >= il.GetInstructionCount()) return "";
             std::vector<InstructionTextToken> tokens;
@@ -127,6 +319,16 @@ void RegisterILBindings(sol::state_view lua, Ref<Logger> logger) {
             return sol::make_object(lua, il[index]);
         },
 
+        // Native walks: iterators over instructions / expressions
+        // and an opcode filter, all optionally over the SSA form.
+        "instructions", &ILInstructions<MediumLevelILFunction>,
+        "expressions", &ILExpressions<MediumLevelILFunction>,
+        "find_ops", &ILFindOps<MediumLevelILFunction>,
+
+        // Compiled tree-pattern search over every expression; see
+        // bindings/il_pattern.cpp for the pattern vocabulary.
+        "match", &MLILFunctionMatch,
+
         "get_text", [](MediumLevelILFunction& il, size_t index) -> std::string {
             if (index >= il.GetInstructionCount()) return "";
             std::vector<InstructionTextToken> tokens;
@@ -215,6 +417,16 @@ void RegisterILBindings(sol::state_view lua, Ref<Logger> logger) {
             return sol::make_object(lua, il.GetExpr(expr_idx, full));
         },
 
+        // Native walks: iterators over instructions / expressions
+        // and an opcode filter, all optionally over the SSA form.
+        "instructions", &ILInstructions<HighLevelILFunction>,
+        "expressions", &ILExpressions<HighLevelILFunction>,
+        "find_ops", &ILFindOps<HighLevelILFunction>,
+
+        // Compiled tree-pattern search over every expression; see
+        // bindings/il_pattern.cpp for the pattern vocabulary.
+        "match", &HLILFunctionMatch,
+
         "get_text", [](HighLevelILFunction& il, size_t index) -> std::string {
             if (index >= il.GetInstructionCount()) return "";
             auto textLines = il.GetInstructionText(index);
@@ -20,11 +20,16 @@
 #include "mediumlevelilinstruction.h"
 #include "highlevelilinstruction.h"
 
+#include <array>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace BinjaLua {
 
+// GENERATED ILOperandTag enum (one enumerator per type_tag string).
+#include "il_operand_tags.inc"
+
 // Per-operand spec emitted by scripts/generate_il_tables.py from
 // python/lowlevelil.py's per-subclass detailed_operands overrides.
 // See docs/il-metatable-design.md section 2c for the type_tag
@@ -38,9 +43,13 @@ namespace BinjaLua {
 // reg_or_flag_ssa_list) still use slot_last == slot_first because BN's
 // GetRawOperandAs*List consumes the (size, operand_idx) pair from a
 // single slot argument internally.
+//
+// tag is the enum form of type_tag; the projectors switch on it and
+// type_tag survives only as the detailed_operands "type" string.
 struct LLILOperandSpec {
     const char* name;
     const char* type_tag;
+    ILOperandTag tag;
     uint8_t slot_first;
     uint8_t slot_last;
 };
@@ -60,6 +69,7 @@ struct LLILOperandSpec {
 struct MLILOperandSpec {
     const char* name;
     const char* type_tag;
+    ILOperandTag tag;
     uint8_t slot_first;
     uint8_t slot_last;
 };
@@ -73,6 +83,7 @@ struct MLILOperandSpec {
 struct HLILOperandSpec {
     const char* name;
     const char* type_tag;
+    ILOperandTag tag;
     uint8_t slot_first;
     uint8_t slot_last;
 };
@@ -99,21 +110,67 @@ const char* EnumToString(BNMediumLevelILOperation v);
 // (enums-only); HLILInstruction usertype in commit B will use it.
 const char* EnumToString(BNHighLevelILOperation v);
 
-// Per-opcode dispatch. Returns a reference to a static empty vector
-// when the opcode has no detailed_operands override in Python (e.g.
+// Opcode parsers (short or verbatim enumerator form), used by the
+// IL function find_ops / instructions / expressions filters in
+// bindings/il.cpp. Definitions live in il_enums.inc.
+template <>
+std::optional<BNLowLevelILOperation> EnumFromString<BNLowLevelILOperation>(
+    const std::string& s);
+template <>
+std::optional<BNMediumLevelILOperation>
+EnumFromString<BNMediumLevelILOperation>(const std::string& s);
+template <>
+std::optional<BNHighLevelILOperation> EnumFromString<BNHighLevelILOperation>(
+    const std::string& s);
+
+// Per-opcode dispatch over the generated constexpr spec arrays.
+// Returns an empty span when the opcode has no detailed_operands
+// override in Python (e.g.
 // LLIL_NOP, LLIL_POP, LLIL_NORET, LLIL_SYSCALL, LLIL_BP, LLIL_UNDEF,
 // LLIL_UNIMPL). Generated implementation lives in
 // bindings/il_operands_table.inc.
-const std::vector<LLILOperandSpec>& LLILOperandSpecsForOperation(
+std::span<const LLILOperandSpec> LLILOperandSpecsForOperation(
     BNLowLevelILOperation op);
 
 // Resolve the owning Architecture for a LowLevelILInstruction, or
 // nullptr when the IL function has no attached BN Function (rare; only
-// occurs with synthetic IL). Every operand projector that turns a
-// register/flag/intrinsic slot into a name string goes through this
-// helper and returns nil on null.
+// occurs with synthetic IL). The operand projectors resolve it once
+// per instruction into an ArchNameTables (below) and return nil for
+// name slots when it is null.
 Ref<Architecture> ArchFor(const LowLevelILInstruction& instr);
 
+// Per-architecture id -> name tables for the operand projectors. The
+// names live in the Lua registry (one record per architecture per Lua
+// state), so a register operand is a raw table lookup on an already
+// interned Lua string instead of a core call plus a std::string copy.
+// Tables are seeded from the architecture's enumerations on first use;
+// ids outside them (LLIL temporaries, ...) are resolved through the
+// core once and then remembered. Build one per instruction (or per
+// function) and pass it to every operand of that instruction.
+class ArchNameTables {
+public:
+    enum Kind {
+        Registers = 1,
+        Flags,
+        RegisterStacks,
+        SemanticClasses,
+        SemanticGroups,
+        Intrinsics,
+    };
+
+    // arch may be null (synthetic IL); every lookup then yields nil.
+    ArchNameTables(sol::state_view lua, Ref<Architecture> arch);
+
+    bool Valid() const { return m_arch.GetPtr() != nullptr; }
+    // nil for ids the architecture cannot name.
+    sol::object Name(Kind kind, uint32_t id) const;
+
+private:
+    sol::state_view m_lua;
+    Ref<Architecture> m_arch;
+    sol::table m_record;
+};
+
 // Project a single operand spec to a Lua value following the type_tag
 // vocabulary at docs/il-metatable-design.md section 2c. Returns
 // sol::nil on architecture-unavailable / sentinel register id /
@@ -122,10 +179,17 @@ Ref<Architecture> ArchFor(const LowLevelILInstruction& instr);
 // (spec.slot_first, spec.name) via ProjectUnknownField.
 sol::object LLILOperandToLua(sol::state_view lua,
                               const LowLevelILInstruction& instr,
-                              const LLILOperandSpec& spec);
+                              const LLILOperandSpec& spec,
+                              const ArchNameTables& names);
 
 // Build the 1-indexed `instr.operands` list: projects each operand
 // spec via LLILOperandToLua without the (name, type) wrapping.
+//
+// The three Build*OperandsTable families below memoize their result
+// per (IL function, expr index, form) in a weak registry cache, so
+// repeated accesses within a GC cycle return the same table. Callers
+// must treat the result as read-only. See OperandTableCache in
+// bindings/il_operand_conv.cpp.
 sol::table BuildLLILOperandsTable(sol::this_state ts,
                                     const LowLevelILInstruction& instr);
 
@@ -151,12 +215,12 @@ sol::table TraverseLLILInstruction(sol::this_state ts,
 
 // ---- MLIL analogs (R9.2 commit B) ----
 
-// Per-opcode dispatch for MLIL. Returns a reference to a static empty
-// vector when the opcode has no detailed_operands override in Python
+// Per-opcode dispatch for MLIL. Returns an empty span when the
+// opcode has no detailed_operands override in Python
 // (MLIL_NOP, MLIL_NORET, MLIL_BP, MLIL_UNDEF, MLIL_UNIMPL, plus any
 // opcodes whose subclass is not concretely defined). Generated in
 // bindings/il_operands_table.inc alongside the LLIL dispatcher.
-const std::vector<MLILOperandSpec>& MLILOperandSpecsForOperation(
+std::span<const MLILOperandSpec> MLILOperandSpecsForOperation(
     BNMediumLevelILOperation op);
 
 // Resolve the owning Architecture for a MediumLevelILInstruction, or
@@ -173,7 +237,8 @@ Ref<Architecture> ArchFor(const MediumLevelILInstruction& instr);
 // only tags) return sol::nil.
 sol::object MLILOperandToLua(sol::state_view lua,
                               const MediumLevelILInstruction& instr,
-                              const MLILOperandSpec& spec);
+                              const MLILOperandSpec& spec,
+                              const ArchNameTables& names);
 
 // Build the 1-indexed `instr.operands` list for an MLIL instruction.
 sol::table BuildMLILOperandsTable(sol::this_state ts,
@@ -195,14 +260,14 @@ sol::table TraverseMLILInstruction(sol::this_state ts,
 
 // ---- HLIL analogs (R9.3 commit B) ----
 
-// Per-opcode dispatch for HLIL. Returns a reference to a static empty
-// vector when the opcode has no detailed_operands override in Python
+// Per-opcode dispatch for HLIL. Returns an empty span when the
+// opcode has no detailed_operands override in Python
 // (HLIL_NOP, HLIL_BREAK, HLIL_CONTINUE, HLIL_NORET, HLIL_UNREACHABLE,
 // HLIL_BP, HLIL_UNDEF, HLIL_UNIMPL, plus any opcodes whose subclass
 // is not concretely defined). Generated in
 // bindings/il_operands_table.inc alongside the LLIL + MLIL
 // dispatchers.
-const std::vector<HLILOperandSpec>& HLILOperandSpecsForOperation(
+std::span<const HLILOperandSpec> HLILOperandSpecsForOperation(
     BNHighLevelILOperation op);
 
 // Resolve the owning Architecture for a HighLevelILInstruction, or
@@ -219,7 +284,8 @@ Ref<Architecture> ArchFor(const HighLevelILInstruction& instr);
 // level tags. Unknown tags return sol::nil.
 sol::object HLILOperandToLua(sol::state_view lua,
                               const HighLevelILInstruction& instr,
-                              const HLILOperandSpec& spec);
+                              const HLILOperandSpec& spec,
+                              const ArchNameTables& names);
 
 // Build the 1-indexed `instr.operands` list for an HLIL instruction.
 sol::table BuildHLILOperandsTable(sol::this_state ts,
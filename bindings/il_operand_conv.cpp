@@ -31,16 +31,26 @@
 //     (140). Produced by scripts/generate_il_tables.py from
 //     binaryninjacore.h.
 //   - bindings/il_operands_table.inc is a GENERATED fragment holding
-//     the per-opcode LLILOperandSpec vectors + LLILOperandSpecsFor-
-//     Operation switch, and the MLIL analogs. Produced by the same
+//     the per-opcode constexpr LLILOperandSpec arrays + LLILOperand-
+//     SpecsForOperation switch, and the MLIL analogs. Produced by the same
 //     generator from python/lowlevelil.py and python/mediumlevelil.py
 //     per-subclass detailed_operands overrides.
+//   - bindings/il_operand_projectors.inc is a GENERATED fragment
+//     holding one straight-line projector per opcode (each slot read
+//     through the matching *OperandAs<Tag> specialization) and the
+//     Project{LLIL,MLIL,HLIL}Operands switches that operands() and
+//     detailed_operands() use.
+//   - bindings/il_operand_tags.inc is a GENERATED fragment holding
+//     the ILOperandTag enum (the integer form of every type_tag
+//     string) that the dispatchers below switch on. Included by
+//     bindings/il.h.
 //   - bindings/il.h declares the *OperandSpec structs, the
 //     projection-helper signatures, and the usertype-registration
 //     entrypoints. Hand-written.
 //   - bindings/il_operand_conv.cpp (THIS file) is HAND-WRITTEN glue.
-//     It #includes the two generated fragments inside the BinjaLua
-//     namespace, then provides the LLILOperandToLua / MLILOperandToLua
+//     It #includes the generated fragments inside the BinjaLua
+//     namespace, then provides the tag-specialized *OperandAs slot
+//     readers, the generic LLILOperandToLua / MLILOperandToLua
 //     dispatchers, the per-instruction operands / detailed_operands
 //     / prefix_operands / traverse worker family (both families), and
 //     the ArchFor helpers.
@@ -55,7 +65,9 @@
 
 #include <cstring>
 #include <map>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace BinjaLua {
@@ -64,6 +76,27 @@ namespace BinjaLua {
 
 #include "il_operands_table.inc"
 
+// Tag-specialized slot readers, defined below. The generated
+// projectors instantiate one per (opcode, operand) pair so the per-
+// opcode path never re-dispatches on spec.tag.
+template <ILOperandTag Tag>
+sol::object LLILOperandAs(sol::state_view lua,
+                          const LowLevelILInstruction& instr,
+                          const LLILOperandSpec& spec,
+                          const ArchNameTables& names);
+template <ILOperandTag Tag>
+sol::object MLILOperandAs(sol::state_view lua,
+                          const MediumLevelILInstruction& instr,
+                          const MLILOperandSpec& spec,
+                          const ArchNameTables& names);
+template <ILOperandTag Tag>
+sol::object HLILOperandAs(sol::state_view lua,
+                          const HighLevelILInstruction& instr,
+                          const HLILOperandSpec& spec,
+                          const ArchNameTables& names);
+
+#include "il_operand_projectors.inc"
+
 namespace {
 
 // Sentinel id signalling "no register". Mirrors the rule already
@@ -71,19 +104,77 @@ namespace {
 // 0xffffffff maps to nil on the Lua side.
 constexpr uint32_t kNoRegisterSentinel = 0xffffffffu;
 
-// Build a {reg|flag = name, version = v} table for SSA entries.
+// Build a {reg|flag = name, version = v} table for SSA entries. An
+// empty name (unresolvable id) projects to nil.
 sol::table MakeSSAEntry(sol::state_view lua, const char* name_key,
-                         const std::string& name, size_t version) {
+                         const sol::object& name, size_t version) {
     sol::table t = lua.create_table(0, 2);
-    if (name.empty()) {
-        t[name_key] = sol::lua_nil_t{};
-    } else {
+    if (name.is<std::string>() && !name.as<std::string_view>().empty()) {
         t[name_key] = name;
+    } else {
+        t[name_key] = sol::lua_nil_t{};
     }
     t["version"] = static_cast<lua_Integer>(version);
     return t;
 }
 
+// Name of id, or nil for the "no register" sentinel.
+sol::object NameOrNil(sol::state_view lua, const ArchNameTables& names,
+                      ArchNameTables::Kind kind, uint32_t id) {
+    if (id == kNoRegisterSentinel) {
+        return sol::make_object(lua, sol::lua_nil_t{});
+    }
+    return names.Name(kind, id);
+}
+
+// Registry key of the {[lightuserdata BNArchitecture*] = record} map
+// behind ArchNameTables.
+constexpr const char* kArchNamesRegistryKey = "binja_lua.arch_names";
+
+// Seed one kind's id -> name table from an architecture enumeration.
+template <typename NameOf>
+sol::table BuildNameTable(sol::state_view lua,
+                          const std::vector<uint32_t>& ids, NameOf name_of) {
+    sol::table t = lua.create_table(0, static_cast<int>(ids.size()));
+    for (uint32_t id : ids) {
+        t.raw_set(id, name_of(id));
+    }
+    return t;
+}
+
+std::string ArchName(Architecture& arch, ArchNameTables::Kind kind,
+                     uint32_t id) {
+    switch (kind) {
+    case ArchNameTables::Registers:       return arch.GetRegisterName(id);
+    case ArchNameTables::Flags:           return arch.GetFlagName(id);
+    case ArchNameTables::RegisterStacks:  return arch.GetRegisterStackName(id);
+    case ArchNameTables::SemanticClasses: return arch.GetSemanticFlagClassName(id);
+    case ArchNameTables::SemanticGroups:  return arch.GetSemanticFlagGroupName(id);
+    case ArchNameTables::Intrinsics:      return arch.GetIntrinsicName(id);
+    }
+    return std::string();
+}
+
+sol::table BuildArchNameRecord(sol::state_view lua, Architecture& arch) {
+    using K = ArchNameTables::Kind;
+    auto seed = [&](K kind, const std::vector<uint32_t>& ids) {
+        return BuildNameTable(lua, ids, [&](uint32_t id) {
+            return ArchName(arch, kind, id);
+        });
+    };
+    sol::table record = lua.create_table(6, 0);
+    record.raw_set(K::Registers, seed(K::Registers, arch.GetAllRegisters()));
+    record.raw_set(K::Flags, seed(K::Flags, arch.GetAllFlags()));
+    record.raw_set(K::RegisterStacks,
+                   seed(K::RegisterStacks, arch.GetAllRegisterStacks()));
+    record.raw_set(K::SemanticClasses,
+                   seed(K::SemanticClasses, arch.GetAllSemanticFlagClasses()));
+    record.raw_set(K::SemanticGroups,
+                   seed(K::SemanticGroups, arch.GetAllSemanticFlagGroups()));
+    record.raw_set(K::Intrinsics, seed(K::Intrinsics, arch.GetAllIntrinsics()));
+    return record;
+}
+
 // Project an expr_list slot to a 1-indexed Lua sequence of nested
 // LowLevelILInstruction usertypes. sol::make_object on the element
 // resolves the usertype metatable at runtime; the usertype is
@@ -118,7 +209,8 @@ sol::table ProjectExprList(sol::state_view lua,
 //     params <- self.param.src, param = self._get_expr(4).
 sol::object ProjectUnknownField(sol::state_view lua,
                                  const LowLevelILInstruction& instr,
-                                 const LLILOperandSpec& spec) {
+                                 const LLILOperandSpec& spec,
+                                 const ArchNameTables& names) {
     const std::string name = spec.name ? spec.name : "";
     BNLowLevelILOperation op = instr.operation;
 
@@ -134,12 +226,8 @@ sol::object ProjectUnknownField(sol::state_view lua,
     }
     if (op == LLIL_SYSCALL_SSA) {
         if (name == "stack_reg") {
-            uint32_t idx = instr.GetRawOperandAsRegister(1);
-            Ref<Architecture> arch = ArchFor(instr);
-            if (!arch || idx == kNoRegisterSentinel) {
-                return sol::make_object(lua, sol::lua_nil_t{});
-            }
-            return sol::make_object(lua, arch->GetRegisterName(idx));
+            return NameOrNil(lua, names, ArchNameTables::Registers,
+                             instr.GetRawOperandAsRegister(1));
         }
         if (name == "stack_memory") {
             return sol::make_object(
@@ -152,6 +240,122 @@ sol::object ProjectUnknownField(sol::state_view lua,
 
 }  // namespace
 
+ArchNameTables::ArchNameTables(sol::state_view lua, Ref<Architecture> arch)
+    : m_lua(lua), m_arch(std::move(arch)) {
+    if (!m_arch) return;
+    sol::table registry = lua.registry();
+    sol::optional<sol::table> all =
+        registry.raw_get<sol::optional<sol::table>>(kArchNamesRegistryKey);
+    if (!all) {
+        all = lua.create_table();
+        registry.raw_set(kArchNamesRegistryKey, *all);
+    }
+    void* key = Architecture::GetObject(m_arch.GetPtr());
+    sol::optional<sol::table> record =
+        all->raw_get<sol::optional<sol::table>>(sol::lightuserdata_value(key));
+    if (!record) {
+        record = BuildArchNameRecord(lua, *m_arch);
+        all->raw_set(sol::lightuserdata_value(key), *record);
+    }
+    m_record = *record;
+}
+
+sol::object ArchNameTables::Name(Kind kind, uint32_t id) const {
+    if (!m_arch) return sol::make_object(m_lua, sol::lua_nil_t{});
+    sol::table names = m_record.raw_get<sol::table>(kind);
+    sol::object name = names.raw_get<sol::object>(id);
+    if (name.get_type() == sol::type::nil) {
+        // Not in the architecture's enumerations; ask once, remember.
+        names.raw_set(id, ArchName(*m_arch, kind, id));
+        name = names.raw_get<sol::object>(id);
+    }
+    return name;
+}
+
+namespace {
+
+// Registry key of the {[lightuserdata BN*LevelILFunction*] = record}
+// map behind OperandTableCache. The map is weak-valued and nothing
+// else references a record, so every record (and every cached table
+// the script is not holding) is dropped at the next full GC cycle.
+constexpr const char* kOperandTablesRegistryKey = "binja_lua.operand_tables";
+
+// Per-IL-function bound. Past it the record is replaced wholesale
+// rather than evicted entry by entry.
+constexpr lua_Integer kOperandTablesPerFunction = 4096;
+
+// Memoizes the operands / detailed_operands / prefix_operands tables
+// of one instruction, keyed by (IL function, expr index, form), so
+// `instr:operands()[1] ... instr:operands()[2]` projects once. A record
+// pins its IL function through an `owner` usertype: while the record
+// is alive the BN object cannot be freed and its address reused.
+// Regenerated IL is a new IL function object, hence a new record;
+// the stale one simply ages out with the GC.
+class OperandTableCache {
+public:
+    enum Form { Operands = 1, Detailed = 2, Prefix = 3 };
+
+    template <typename ILFunction>
+    OperandTableCache(sol::state_view lua, const Ref<ILFunction>& func,
+                      size_t exprIndex, Form form, bool ast = false)
+        : m_lua(lua) {
+        if (!func) return;
+        m_key = (static_cast<lua_Integer>(exprIndex) << 3) |
+                (ast ? 4 : 0) | form;
+        sol::table registry = lua.registry();
+        sol::optional<sol::table> all =
+            registry.raw_get<sol::optional<sol::table>>(
+                kOperandTablesRegistryKey);
+        if (!all) {
+            all = lua.create_table();
+            sol::table mt = lua.create_table(0, 1);
+            mt.raw_set("__mode", "v");
+            all->set(sol::metatable_key, mt);
+            registry.raw_set(kOperandTablesRegistryKey, *all);
+        }
+        m_all = *all;
+        m_func = sol::lightuserdata_value(ILFunction::GetObject(func.GetPtr()));
+        sol::optional<sol::table> record =
+            m_all.raw_get<sol::optional<sol::table>>(m_func);
+        if (record) {
+            m_record = *record;
+        } else {
+            m_owner = sol::make_object(lua, func);
+        }
+    }
+
+    sol::optional<sol::table> Find() const {
+        if (!m_record.valid()) return sol::nullopt;
+        return m_record.raw_get<sol::optional<sol::table>>(m_key);
+    }
+
+    sol::table Store(sol::table t) {
+        if (m_key == 0) return t;
+        if (m_record.valid()) {
+            lua_Integer count = m_record.raw_get_or("count", lua_Integer{0});
+            if (count < kOperandTablesPerFunction) {
+                m_record.raw_set(m_key, t, "count", count + 1);
+                return t;
+            }
+            m_owner = m_record.raw_get<sol::object>("owner");
+        }
+        m_record = m_lua.create_table(0, 2);
+        m_record.raw_set("owner", m_owner, "count", lua_Integer{1}, m_key, t);
+        m_all.raw_set(m_func, m_record);
+        return t;
+    }
+
+private:
+    sol::state_view m_lua;
+    lua_Integer m_key = 0;
+    sol::table m_all;
+    sol::lightuserdata_value m_func{nullptr};
+    sol::table m_record;
+    sol::object m_owner;
+};
+
+}  // namespace
+
 Ref<Architecture> ArchFor(const LowLevelILInstruction& instr) {
     if (!instr.function) return Ref<Architecture>();
     Ref<Function> f = instr.function->GetFunction();
@@ -159,18 +363,18 @@ Ref<Architecture> ArchFor(const LowLevelILInstruction& instr) {
     return f->GetArchitecture();
 }
 
-sol::object LLILOperandToLua(sol::state_view lua,
-                              const LowLevelILInstruction& instr,
-                              const LLILOperandSpec& spec) {
-    const std::string tag = spec.type_tag ? spec.type_tag : "";
-    const size_t slot = spec.slot_first;
+template <ILOperandTag Tag>
+sol::object LLILOperandAs(sol::state_view lua,
+                          const LowLevelILInstruction& instr,
+                          const LLILOperandSpec& spec,
+                          const ArchNameTables& names) {
+    [[maybe_unused]] const size_t slot = spec.slot_first;
 
-    if (tag == "int") {
+    if constexpr (Tag == ILOperandTag::Int) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         return sol::make_object(lua,
             static_cast<lua_Integer>(static_cast<int64_t>(raw)));
-    }
-    if (tag == "float") {
+    } else if constexpr (Tag == ILOperandTag::Float) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         double d = 0.0;
         if (instr.size == 4) {
@@ -182,78 +386,59 @@ sol::object LLILOperandToLua(sol::state_view lua,
             std::memcpy(&d, &raw, sizeof(d));
         }
         return sol::make_object(lua, d);
-    }
-    if (tag == "expr") {
+    } else if constexpr (Tag == ILOperandTag::Expr) {
         return sol::make_object(lua, instr.GetRawOperandAsExpr(slot));
-    }
-    if (tag == "expr_list") {
+    } else if constexpr (Tag == ILOperandTag::ExprList) {
         return sol::make_object(lua, ProjectExprList(lua, instr, slot));
-    }
-    if (tag == "int_list") {
+    } else if constexpr (Tag == ILOperandTag::IntList) {
         sol::table t = lua.create_table();
         int i = 1;
         for (auto v : instr.GetRawOperandAsIndexList(slot)) {
             t[i++] = static_cast<lua_Integer>(v);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg") {
-        Ref<Architecture> arch = ArchFor(instr);
+    } else if constexpr (Tag == ILOperandTag::Reg) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
-        if (!arch || idx == kNoRegisterSentinel) {
+        if (idx == kNoRegisterSentinel) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua, arch->GetRegisterName(idx));
-    }
-    if (tag == "flag") {
-        Ref<Architecture> arch = ArchFor(instr);
+        return names.Name(ArchNameTables::Registers, idx);
+    } else if constexpr (Tag == ILOperandTag::Flag) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
-        if (!arch || idx == kNoRegisterSentinel) {
+        if (idx == kNoRegisterSentinel) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua, arch->GetFlagName(idx));
-    }
-    if (tag == "reg_stack") {
-        Ref<Architecture> arch = ArchFor(instr);
+        return names.Name(ArchNameTables::Flags, idx);
+    } else if constexpr (Tag == ILOperandTag::RegStack) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
-        if (!arch || idx == kNoRegisterSentinel) {
+        if (idx == kNoRegisterSentinel) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua, arch->GetRegisterStackName(idx));
-    }
-    if (tag == "sem_class") {
-        Ref<Architecture> arch = ArchFor(instr);
+        return names.Name(ArchNameTables::RegisterStacks, idx);
+    } else if constexpr (Tag == ILOperandTag::SemClass) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
         // python/lowlevelil.py:1089: sem_class idx == 0 is None.
-        if (!arch || idx == 0) {
+        if (idx == 0) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua,
-            arch->GetSemanticFlagClassName(idx));
-    }
-    if (tag == "sem_group") {
-        Ref<Architecture> arch = ArchFor(instr);
+        return names.Name(ArchNameTables::SemanticClasses, idx);
+    } else if constexpr (Tag == ILOperandTag::SemGroup) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
-        if (!arch || idx == kNoRegisterSentinel) {
+        if (idx == kNoRegisterSentinel) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua,
-            arch->GetSemanticFlagGroupName(idx));
-    }
-    if (tag == "intrinsic") {
-        Ref<Architecture> arch = ArchFor(instr);
+        return names.Name(ArchNameTables::SemanticGroups, idx);
+    } else if constexpr (Tag == ILOperandTag::Intrinsic) {
         uint32_t idx = instr.GetRawOperandAsRegister(slot);
-        if (!arch || idx == kNoRegisterSentinel) {
+        if (idx == kNoRegisterSentinel) {
             return sol::make_object(lua, sol::lua_nil_t{});
         }
-        return sol::make_object(lua, arch->GetIntrinsicName(idx));
-    }
-    if (tag == "cond") {
+        return names.Name(ArchNameTables::Intrinsics, idx);
+    } else if constexpr (Tag == ILOperandTag::Cond) {
         BNLowLevelILFlagCondition c =
             instr.GetRawOperandAsFlagCondition(slot);
         return sol::make_object(lua, std::string(EnumToString(c)));
-    }
-    if (tag == "target_map") {
+    } else if constexpr (Tag == ILOperandTag::TargetMap) {
         sol::table t = lua.create_table();
         std::map<uint64_t, uint64_t> m =
             instr.GetRawOperandAsIndexMap(slot);
@@ -262,161 +447,112 @@ sol::object LLILOperandToLua(sol::state_view lua,
                 static_cast<lua_Integer>(entry.second);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg_stack_adjust") {
+    } else if constexpr (Tag == ILOperandTag::RegStackAdjust) {
         sol::table t = lua.create_table();
         std::map<uint32_t, int32_t> adjusts =
             instr.GetRawOperandAsRegisterStackAdjustments(slot);
-        Ref<Architecture> arch = ArchFor(instr);
-        if (arch) {
+        if (names.Valid()) {
             for (const auto& entry : adjusts) {
-                t[arch->GetRegisterStackName(entry.first)] =
+                t[names.Name(ArchNameTables::RegisterStacks, entry.first)] =
                     static_cast<lua_Integer>(entry.second);
             }
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg_ssa") {
+    } else if constexpr (Tag == ILOperandTag::RegSSA) {
         SSARegister ssa = instr.GetRawOperandAsSSARegister(slot);
-        Ref<Architecture> arch = ArchFor(instr);
-        std::string n;
-        if (arch && ssa.reg != kNoRegisterSentinel) {
-            n = arch->GetRegisterName(ssa.reg);
-        }
-        return sol::make_object(lua,
-            MakeSSAEntry(lua, "reg", n, ssa.version));
-    }
-    if (tag == "reg_stack_ssa") {
+        return sol::make_object(lua, MakeSSAEntry(lua, "reg",
+            NameOrNil(lua, names, ArchNameTables::Registers, ssa.reg),
+            ssa.version));
+    } else if constexpr (Tag == ILOperandTag::RegStackSSA) {
         SSARegisterStack ssa =
             instr.GetRawOperandAsSSARegisterStack(slot);
-        Ref<Architecture> arch = ArchFor(instr);
-        std::string n;
-        if (arch && ssa.regStack != kNoRegisterSentinel) {
-            n = arch->GetRegisterStackName(ssa.regStack);
-        }
-        return sol::make_object(lua,
-            MakeSSAEntry(lua, "reg_stack", n, ssa.version));
-    }
-    if (tag == "reg_stack_ssa_dest_and_src") {
+        return sol::make_object(lua, MakeSSAEntry(lua, "reg_stack",
+            NameOrNil(lua, names, ArchNameTables::RegisterStacks,
+                      ssa.regStack),
+            ssa.version));
+    } else if constexpr (Tag == ILOperandTag::RegStackSSADestAndSrc) {
         SSARegisterStack src =
             instr.GetRawOperandAsPartialSSARegisterStackSource(slot);
         sol::table t = lua.create_table(0, 3);
-        Ref<Architecture> arch = ArchFor(instr);
-        if (arch && src.regStack != kNoRegisterSentinel) {
-            t["reg_stack"] = arch->GetRegisterStackName(src.regStack);
-        } else {
-            t["reg_stack"] = sol::lua_nil_t{};
-        }
+        t["reg_stack"] = NameOrNil(lua, names, ArchNameTables::RegisterStacks,
+                                   src.regStack);
         t["version"] = static_cast<lua_Integer>(src.version);
         t["source_version"] = static_cast<lua_Integer>(src.version);
         return sol::make_object(lua, t);
-    }
-    if (tag == "flag_ssa") {
+    } else if constexpr (Tag == ILOperandTag::FlagSSA) {
         SSAFlag ssa = instr.GetRawOperandAsSSAFlag(slot);
-        Ref<Architecture> arch = ArchFor(instr);
-        std::string n;
-        if (arch && ssa.flag != kNoRegisterSentinel) {
-            n = arch->GetFlagName(ssa.flag);
-        }
-        return sol::make_object(lua,
-            MakeSSAEntry(lua, "flag", n, ssa.version));
-    }
-    if (tag == "reg_ssa_list") {
+        return sol::make_object(lua, MakeSSAEntry(lua, "flag",
+            NameOrNil(lua, names, ArchNameTables::Flags, ssa.flag),
+            ssa.version));
+    } else if constexpr (Tag == ILOperandTag::RegSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
-        Ref<Architecture> arch = ArchFor(instr);
         for (auto ssa : instr.GetRawOperandAsSSARegisterList(slot)) {
-            std::string n;
-            if (arch && ssa.reg != kNoRegisterSentinel) {
-                n = arch->GetRegisterName(ssa.reg);
-            }
-            t[i++] = MakeSSAEntry(lua, "reg", n, ssa.version);
+            t[i++] = MakeSSAEntry(lua, "reg",
+                NameOrNil(lua, names, ArchNameTables::Registers, ssa.reg),
+                ssa.version);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg_stack_ssa_list") {
+    } else if constexpr (Tag == ILOperandTag::RegStackSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
-        Ref<Architecture> arch = ArchFor(instr);
         for (auto ssa :
              instr.GetRawOperandAsSSARegisterStackList(slot)) {
-            std::string n;
-            if (arch && ssa.regStack != kNoRegisterSentinel) {
-                n = arch->GetRegisterStackName(ssa.regStack);
-            }
-            t[i++] = MakeSSAEntry(lua, "reg_stack", n, ssa.version);
+            t[i++] = MakeSSAEntry(lua, "reg_stack",
+                NameOrNil(lua, names, ArchNameTables::RegisterStacks,
+                          ssa.regStack),
+                ssa.version);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "flag_ssa_list") {
+    } else if constexpr (Tag == ILOperandTag::FlagSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
-        Ref<Architecture> arch = ArchFor(instr);
         for (auto ssa : instr.GetRawOperandAsSSAFlagList(slot)) {
-            std::string n;
-            if (arch && ssa.flag != kNoRegisterSentinel) {
-                n = arch->GetFlagName(ssa.flag);
-            }
-            t[i++] = MakeSSAEntry(lua, "flag", n, ssa.version);
+            t[i++] = MakeSSAEntry(lua, "flag",
+                NameOrNil(lua, names, ArchNameTables::Flags, ssa.flag),
+                ssa.version);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg_or_flag_list") {
+    } else if constexpr (Tag == ILOperandTag::RegOrFlagList) {
         // Discriminated table per py-researcher-2 recommendation:
         // {kind = "reg" | "flag", name = <str>} so scripts can tell
         // register vs flag slots apart without re-resolving by name.
         sol::table t = lua.create_table();
         int i = 1;
-        Ref<Architecture> arch = ArchFor(instr);
         for (auto rf :
              instr.GetRawOperandAsRegisterOrFlagList(slot)) {
             sol::table entry = lua.create_table(0, 2);
-            if (!arch) {
-                entry["kind"] = rf.isFlag ? "flag" : "reg";
-                entry["name"] = sol::lua_nil_t{};
-            } else if (rf.isFlag) {
-                entry["kind"] = "flag";
-                entry["name"] = arch->GetFlagName(rf.index);
-            } else {
-                entry["kind"] = "reg";
-                entry["name"] = arch->GetRegisterName(rf.index);
-            }
+            entry["kind"] = rf.isFlag ? "flag" : "reg";
+            entry["name"] = names.Name(rf.isFlag ? ArchNameTables::Flags
+                                                 : ArchNameTables::Registers,
+                                       rf.index);
             t[i++] = entry;
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "reg_or_flag_ssa_list") {
+    } else if constexpr (Tag == ILOperandTag::RegOrFlagSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
-        Ref<Architecture> arch = ArchFor(instr);
         for (auto rf :
              instr.GetRawOperandAsSSARegisterOrFlagList(slot)) {
             sol::table entry = lua.create_table(0, 3);
-            if (!arch) {
-                entry["kind"] = rf.regOrFlag.isFlag ? "flag" : "reg";
-                entry["name"] = sol::lua_nil_t{};
-            } else if (rf.regOrFlag.isFlag) {
-                entry["kind"] = "flag";
-                entry["name"] = arch->GetFlagName(rf.regOrFlag.index);
-            } else {
-                entry["kind"] = "reg";
-                entry["name"] = arch->GetRegisterName(rf.regOrFlag.index);
-            }
+            entry["kind"] = rf.regOrFlag.isFlag ? "flag" : "reg";
+            entry["name"] = names.Name(
+                rf.regOrFlag.isFlag ? ArchNameTables::Flags
+                                    : ArchNameTables::Registers,
+                rf.regOrFlag.index);
             entry["version"] = static_cast<lua_Integer>(rf.version);
             t[i++] = entry;
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "constraint") {
+    } else if constexpr (Tag == ILOperandTag::Constraint) {
         // R9.1 stub per docs/il-metatable-design.md section 2c.
         // Full PossibleValueSet projection defers to the dataflow wave.
         sol::table t = lua.create_table(0, 2);
         t["type"] = "constraint";
         t["repr"] = "PossibleValueSet";
         return sol::make_object(lua, t);
-    }
-    if (tag == "unknown") {
-        return ProjectUnknownField(lua, instr, spec);
+    } else if constexpr (Tag == ILOperandTag::Unknown) {
+        return ProjectUnknownField(lua, instr, spec, names);
     }
 
     // Generator should have covered every tag; a miss returns nil so
@@ -424,60 +560,77 @@ sol::object LLILOperandToLua(sol::state_view lua,
     return sol::make_object(lua, sol::lua_nil_t{});
 }
 
+sol::object LLILOperandToLua(sol::state_view lua,
+                              const LowLevelILInstruction& instr,
+                              const LLILOperandSpec& spec,
+                              const ArchNameTables& names) {
+    return VisitOperandTag(spec.tag, [&]<ILOperandTag Tag>() {
+        return LLILOperandAs<Tag>(lua, instr, spec, names);
+    });
+}
+
 sol::table BuildLLILOperandsTable(sol::this_state ts,
                                     const LowLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<LLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Operands);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const LLILOperandSpec> specs =
         LLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const LLILOperandSpec& spec : specs) {
-        out[i++] = LLILOperandToLua(lua, instr, spec);
-    }
-    return out;
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const LLILOperandSpec&, sol::object value) {
+        out.raw_set(i, std::move(value));
+    };
+    ProjectLLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 sol::table BuildLLILDetailedOperandsTable(
     sol::this_state ts, const LowLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<LLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Detailed);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const LLILOperandSpec> specs =
         LLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const LLILOperandSpec& spec : specs) {
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const LLILOperandSpec& spec, sol::object value) {
         sol::table entry = lua.create_table(0, 3);
         entry["name"] = std::string(spec.name ? spec.name : "");
         entry["type"] = std::string(spec.type_tag ? spec.type_tag : "");
-        entry["value"] = LLILOperandToLua(lua, instr, spec);
-        out[i++] = entry;
-    }
-    return out;
+        entry["value"] = std::move(value);
+        out.raw_set(i, entry);
+    };
+    ProjectLLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 namespace {
 
 void AppendPrefixOperands(sol::state_view lua, sol::table& out, int& idx,
-                           const LowLevelILInstruction& instr) {
+                           const LowLevelILInstruction& instr,
+                           const ArchNameTables& names) {
     sol::table marker = lua.create_table(0, 2);
     marker["operation"] = std::string(EnumToString(instr.operation));
     marker["size"] = static_cast<lua_Integer>(instr.size);
     out[idx++] = marker;
 
-    const std::vector<LLILOperandSpec>& specs =
+    std::span<const LLILOperandSpec> specs =
         LLILOperandSpecsForOperation(instr.operation);
     for (const LLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             LowLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
-            AppendPrefixOperands(lua, out, idx, nested);
-        } else if (tag == "expr_list") {
+            AppendPrefixOperands(lua, out, idx, nested, names);
+        } else if (spec.tag == ILOperandTag::ExprList) {
             for (auto nested :
                  instr.GetRawOperandAsExprList(spec.slot_first)) {
-                AppendPrefixOperands(lua, out, idx, nested);
+                AppendPrefixOperands(lua, out, idx, nested, names);
             }
         } else {
-            out[idx++] = LLILOperandToLua(lua, instr, spec);
+            out[idx++] = LLILOperandToLua(lua, instr, spec, names);
         }
     }
 }
@@ -487,10 +640,14 @@ void AppendPrefixOperands(sol::state_view lua, sol::table& out, int& idx,
 sol::table BuildLLILPrefixOperandsTable(
     sol::this_state ts, const LowLevelILInstruction& instr) {
     sol::state_view lua(ts);
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Prefix);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
     sol::table out = lua.create_table();
     int idx = 1;
-    AppendPrefixOperands(lua, out, idx, instr);
-    return out;
+    ArchNameTables names(lua, ArchFor(instr));
+    AppendPrefixOperands(lua, out, idx, instr, names);
+    return cache.Store(out);
 }
 
 namespace {
@@ -505,15 +662,14 @@ void TraverseRecursive(sol::state_view lua, sol::table& results, int& idx,
             results[idx++] = result;
         }
     }
-    const std::vector<LLILOperandSpec>& specs =
+    std::span<const LLILOperandSpec> specs =
         LLILOperandSpecsForOperation(instr.operation);
     for (const LLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             LowLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
             TraverseRecursive(lua, results, idx, nested, cb);
-        } else if (tag == "expr_list") {
+        } else if (spec.tag == ILOperandTag::ExprList) {
             for (auto nested :
                  instr.GetRawOperandAsExprList(spec.slot_first)) {
                 TraverseRecursive(lua, results, idx, nested, cb);
@@ -599,18 +755,18 @@ sol::table ProjectMLILExprList(sol::state_view lua,
 
 }  // namespace
 
-sol::object MLILOperandToLua(sol::state_view lua,
-                              const MediumLevelILInstruction& instr,
-                              const MLILOperandSpec& spec) {
-    const std::string tag = spec.type_tag ? spec.type_tag : "";
-    const size_t slot = spec.slot_first;
+template <ILOperandTag Tag>
+sol::object MLILOperandAs(sol::state_view lua,
+                          const MediumLevelILInstruction& instr,
+                          const MLILOperandSpec& spec,
+                          const ArchNameTables& names) {
+    [[maybe_unused]] const size_t slot = spec.slot_first;
 
-    if (tag == "int") {
+    if constexpr (Tag == ILOperandTag::Int) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         return sol::make_object(lua,
             static_cast<lua_Integer>(static_cast<int64_t>(raw)));
-    }
-    if (tag == "float") {
+    } else if constexpr (Tag == ILOperandTag::Float) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         double d = 0.0;
         if (instr.size == 4) {
@@ -622,14 +778,11 @@ sol::object MLILOperandToLua(sol::state_view lua,
             std::memcpy(&d, &raw, sizeof(d));
         }
         return sol::make_object(lua, d);
-    }
-    if (tag == "expr") {
+    } else if constexpr (Tag == ILOperandTag::Expr) {
         return sol::make_object(lua, instr.GetRawOperandAsExpr(slot));
-    }
-    if (tag == "expr_list") {
+    } else if constexpr (Tag == ILOperandTag::ExprList) {
         return sol::make_object(lua, ProjectMLILExprList(lua, instr, slot));
-    }
-    if (tag == "int_list") {
+    } else if constexpr (Tag == ILOperandTag::IntList) {
         sol::table t = lua.create_table();
         int i = 1;
         auto list = instr.GetRawOperandAsIndexList(slot);
@@ -637,8 +790,7 @@ sol::object MLILOperandToLua(sol::state_view lua,
             t[i++] = static_cast<lua_Integer>(list[k]);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "target_map") {
+    } else if constexpr (Tag == ILOperandTag::TargetMap) {
         sol::table t = lua.create_table();
         std::map<uint64_t, size_t> m =
             instr.GetRawOperandAsIndexMap(slot);
@@ -647,33 +799,24 @@ sol::object MLILOperandToLua(sol::state_view lua,
                 static_cast<lua_Integer>(entry.second);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "intrinsic") {
-        Ref<Architecture> arch = ArchFor(instr);
+    } else if constexpr (Tag == ILOperandTag::Intrinsic) {
         uint32_t idx = static_cast<uint32_t>(
             instr.GetRawOperandAsInteger(slot) & 0xffffffffu);
-        if (!arch || idx == 0xffffffffu) {
-            return sol::make_object(lua, sol::lua_nil_t{});
-        }
-        return sol::make_object(lua, arch->GetIntrinsicName(idx));
-    }
-    if (tag == "cond") {
+        return NameOrNil(lua, names, ArchNameTables::Intrinsics, idx);
+    } else if constexpr (Tag == ILOperandTag::Cond) {
         // Shared with LLIL: MLIL uses the same BNLowLevelILFlagCondition
         // vocabulary for flag-condition slots.
         BNLowLevelILFlagCondition c =
             static_cast<BNLowLevelILFlagCondition>(
                 instr.GetRawOperandAsInteger(slot));
         return sol::make_object(lua, std::string(EnumToString(c)));
-    }
-    if (tag == "var") {
+    } else if constexpr (Tag == ILOperandTag::Var) {
         Variable v = instr.GetRawOperandAsVariable(slot);
         return sol::make_object(lua, VariableToTable(lua, v));
-    }
-    if (tag == "var_ssa") {
+    } else if constexpr (Tag == ILOperandTag::VarSSA) {
         SSAVariable ssa = instr.GetRawOperandAsSSAVariable(slot);
         return sol::make_object(lua, SSAVariableToTable(lua, ssa));
-    }
-    if (tag == "var_list") {
+    } else if constexpr (Tag == ILOperandTag::VarList) {
         sol::table t = lua.create_table();
         int i = 1;
         auto list = instr.GetRawOperandAsVariableList(slot);
@@ -681,8 +824,7 @@ sol::object MLILOperandToLua(sol::state_view lua,
             t[i++] = VariableToTable(lua, list[k]);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "var_ssa_list") {
+    } else if constexpr (Tag == ILOperandTag::VarSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
         auto list = instr.GetRawOperandAsSSAVariableList(slot);
@@ -690,8 +832,7 @@ sol::object MLILOperandToLua(sol::state_view lua,
             t[i++] = SSAVariableToTable(lua, list[k]);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "var_ssa_dest_and_src") {
+    } else if constexpr (Tag == ILOperandTag::VarSSADestAndSrc) {
         // GetRawOperandAsPartialSSAVariableSource consumes the
         // (var_identifier, src_version) pair at slot and slot+1. The
         // generator emits the spec with slot_last == slot_first + 1
@@ -701,8 +842,7 @@ sol::object MLILOperandToLua(sol::state_view lua,
         SSAVariable ssa =
             instr.GetRawOperandAsPartialSSAVariableSource(slot);
         return sol::make_object(lua, SSAVariableToTable(lua, ssa));
-    }
-    if (tag == "ConstantData") {
+    } else if constexpr (Tag == ILOperandTag::ConstantData) {
         ConstantData cd = instr.GetRawOperandAsConstantData(slot);
         return sol::make_object(lua, ConstantDataToTable(lua, cd));
     }
@@ -712,62 +852,79 @@ sol::object MLILOperandToLua(sol::state_view lua,
     return sol::make_object(lua, sol::lua_nil_t{});
 }
 
+sol::object MLILOperandToLua(sol::state_view lua,
+                              const MediumLevelILInstruction& instr,
+                              const MLILOperandSpec& spec,
+                              const ArchNameTables& names) {
+    return VisitOperandTag(spec.tag, [&]<ILOperandTag Tag>() {
+        return MLILOperandAs<Tag>(lua, instr, spec, names);
+    });
+}
+
 sol::table BuildMLILOperandsTable(sol::this_state ts,
                                     const MediumLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<MLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Operands);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const MLILOperandSpec> specs =
         MLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const MLILOperandSpec& spec : specs) {
-        out[i++] = MLILOperandToLua(lua, instr, spec);
-    }
-    return out;
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const MLILOperandSpec&, sol::object value) {
+        out.raw_set(i, std::move(value));
+    };
+    ProjectMLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 sol::table BuildMLILDetailedOperandsTable(
     sol::this_state ts, const MediumLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<MLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Detailed);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const MLILOperandSpec> specs =
         MLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const MLILOperandSpec& spec : specs) {
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const MLILOperandSpec& spec, sol::object value) {
         sol::table entry = lua.create_table(0, 3);
         entry["name"] = std::string(spec.name ? spec.name : "");
         entry["type"] = std::string(spec.type_tag ? spec.type_tag : "");
-        entry["value"] = MLILOperandToLua(lua, instr, spec);
-        out[i++] = entry;
-    }
-    return out;
+        entry["value"] = std::move(value);
+        out.raw_set(i, entry);
+    };
+    ProjectMLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 namespace {
 
 void AppendMLILPrefixOperands(sol::state_view lua, sol::table& out,
                                 int& idx,
-                                const MediumLevelILInstruction& instr) {
+                                const MediumLevelILInstruction& instr,
+                                const ArchNameTables& names) {
     sol::table marker = lua.create_table(0, 2);
     marker["operation"] = std::string(EnumToString(instr.operation));
     marker["size"] = static_cast<lua_Integer>(instr.size);
     out[idx++] = marker;
 
-    const std::vector<MLILOperandSpec>& specs =
+    std::span<const MLILOperandSpec> specs =
         MLILOperandSpecsForOperation(instr.operation);
     for (const MLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             MediumLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
-            AppendMLILPrefixOperands(lua, out, idx, nested);
-        } else if (tag == "expr_list") {
+            AppendMLILPrefixOperands(lua, out, idx, nested, names);
+        } else if (spec.tag == ILOperandTag::ExprList) {
             auto list = instr.GetRawOperandAsExprList(spec.slot_first);
             for (size_t k = 0; k < list.size(); ++k) {
                 MediumLevelILInstruction nested = list[k];
-                AppendMLILPrefixOperands(lua, out, idx, nested);
+                AppendMLILPrefixOperands(lua, out, idx, nested, names);
             }
         } else {
-            out[idx++] = MLILOperandToLua(lua, instr, spec);
+            out[idx++] = MLILOperandToLua(lua, instr, spec, names);
         }
     }
 }
@@ -777,10 +934,14 @@ void AppendMLILPrefixOperands(sol::state_view lua, sol::table& out,
 sol::table BuildMLILPrefixOperandsTable(
     sol::this_state ts, const MediumLevelILInstruction& instr) {
     sol::state_view lua(ts);
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Prefix);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
     sol::table out = lua.create_table();
     int idx = 1;
-    AppendMLILPrefixOperands(lua, out, idx, instr);
-    return out;
+    ArchNameTables names(lua, ArchFor(instr));
+    AppendMLILPrefixOperands(lua, out, idx, instr, names);
+    return cache.Store(out);
 }
 
 namespace {
@@ -796,15 +957,14 @@ void TraverseMLILRecursive(sol::state_view lua, sol::table& results,
             results[idx++] = result;
         }
     }
-    const std::vector<MLILOperandSpec>& specs =
+    std::span<const MLILOperandSpec> specs =
         MLILOperandSpecsForOperation(instr.operation);
     for (const MLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             MediumLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
             TraverseMLILRecursive(lua, results, idx, nested, cb);
-        } else if (tag == "expr_list") {
+        } else if (spec.tag == ILOperandTag::ExprList) {
             auto list = instr.GetRawOperandAsExprList(spec.slot_first);
             for (size_t k = 0; k < list.size(); ++k) {
                 MediumLevelILInstruction nested = list[k];
@@ -880,18 +1040,18 @@ sol::table ProjectHLILExprList(sol::state_view lua,
 
 }  // namespace
 
-sol::object HLILOperandToLua(sol::state_view lua,
-                              const HighLevelILInstruction& instr,
-                              const HLILOperandSpec& spec) {
-    const std::string tag = spec.type_tag ? spec.type_tag : "";
-    const size_t slot = spec.slot_first;
+template <ILOperandTag Tag>
+sol::object HLILOperandAs(sol::state_view lua,
+                          const HighLevelILInstruction& instr,
+                          const HLILOperandSpec& spec,
+                          const ArchNameTables& names) {
+    [[maybe_unused]] const size_t slot = spec.slot_first;
 
-    if (tag == "int") {
+    if constexpr (Tag == ILOperandTag::Int) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         return sol::make_object(lua,
             static_cast<lua_Integer>(static_cast<int64_t>(raw)));
-    }
-    if (tag == "float") {
+    } else if constexpr (Tag == ILOperandTag::Float) {
         uint64_t raw = instr.GetRawOperandAsInteger(slot);
         double d = 0.0;
         if (instr.size == 4) {
@@ -903,14 +1063,11 @@ sol::object HLILOperandToLua(sol::state_view lua,
             std::memcpy(&d, &raw, sizeof(d));
         }
         return sol::make_object(lua, d);
-    }
-    if (tag == "expr") {
+    } else if constexpr (Tag == ILOperandTag::Expr) {
         return sol::make_object(lua, instr.GetRawOperandAsExpr(slot));
-    }
-    if (tag == "expr_list") {
+    } else if constexpr (Tag == ILOperandTag::ExprList) {
         return sol::make_object(lua, ProjectHLILExprList(lua, instr, slot));
-    }
-    if (tag == "int_list") {
+    } else if constexpr (Tag == ILOperandTag::IntList) {
         sol::table t = lua.create_table();
         int i = 1;
         auto list = instr.GetRawOperandAsIndexList(slot);
@@ -918,28 +1075,20 @@ sol::object HLILOperandToLua(sol::state_view lua,
             t[i++] = static_cast<lua_Integer>(list[k]);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "intrinsic") {
-        Ref<Architecture> arch = ArchFor(instr);
+    } else if constexpr (Tag == ILOperandTag::Intrinsic) {
         uint32_t idx = static_cast<uint32_t>(
             instr.GetRawOperandAsInteger(slot) & 0xffffffffu);
-        if (!arch || idx == 0xffffffffu) {
-            return sol::make_object(lua, sol::lua_nil_t{});
-        }
-        return sol::make_object(lua, arch->GetIntrinsicName(idx));
-    }
-    if (tag == "var") {
+        return NameOrNil(lua, names, ArchNameTables::Intrinsics, idx);
+    } else if constexpr (Tag == ILOperandTag::Var) {
         // VariableToTable defined in the MLIL section above; same
         // {source_type, index, storage} shape. R9.3 reuses it intact
         // per spec section 13.3.
         Variable v = instr.GetRawOperandAsVariable(slot);
         return sol::make_object(lua, VariableToTable(lua, v));
-    }
-    if (tag == "var_ssa") {
+    } else if constexpr (Tag == ILOperandTag::VarSSA) {
         SSAVariable ssa = instr.GetRawOperandAsSSAVariable(slot);
         return sol::make_object(lua, SSAVariableToTable(lua, ssa));
-    }
-    if (tag == "var_ssa_list") {
+    } else if constexpr (Tag == ILOperandTag::VarSSAList) {
         sol::table t = lua.create_table();
         int i = 1;
         auto list = instr.GetRawOperandAsSSAVariableList(slot);
@@ -947,17 +1096,14 @@ sol::object HLILOperandToLua(sol::state_view lua,
             t[i++] = SSAVariableToTable(lua, list[k]);
         }
         return sol::make_object(lua, t);
-    }
-    if (tag == "ConstantData") {
+    } else if constexpr (Tag == ILOperandTag::ConstantData) {
         ConstantData cd = instr.GetRawOperandAsConstantData(slot);
         return sol::make_object(lua, ConstantDataToTable(lua, cd));
-    }
-    if (tag == "label") {
+    } else if constexpr (Tag == ILOperandTag::Label) {
         uint64_t label_id = instr.GetRawOperandAsInteger(slot);
         return sol::make_object(lua,
             GotoLabelToTable(lua, instr, label_id));
-    }
-    if (tag == "member_index") {
+    } else if constexpr (Tag == ILOperandTag::MemberIndex) {
         // Python's _get_member_index returns None when the high bit
         // of the raw operand is set, otherwise the raw value. Preserve
         // that contract on the Lua side as nil vs integer.
@@ -974,62 +1120,79 @@ sol::object HLILOperandToLua(sol::state_view lua,
     return sol::make_object(lua, sol::lua_nil_t{});
 }
 
+sol::object HLILOperandToLua(sol::state_view lua,
+                              const HighLevelILInstruction& instr,
+                              const HLILOperandSpec& spec,
+                              const ArchNameTables& names) {
+    return VisitOperandTag(spec.tag, [&]<ILOperandTag Tag>() {
+        return HLILOperandAs<Tag>(lua, instr, spec, names);
+    });
+}
+
 sol::table BuildHLILOperandsTable(sol::this_state ts,
                                     const HighLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<HLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Operands, instr.ast);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const HLILOperandSpec> specs =
         HLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const HLILOperandSpec& spec : specs) {
-        out[i++] = HLILOperandToLua(lua, instr, spec);
-    }
-    return out;
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const HLILOperandSpec&, sol::object value) {
+        out.raw_set(i, std::move(value));
+    };
+    ProjectHLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 sol::table BuildHLILDetailedOperandsTable(
     sol::this_state ts, const HighLevelILInstruction& instr) {
     sol::state_view lua(ts);
-    sol::table out = lua.create_table();
-    const std::vector<HLILOperandSpec>& specs =
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Detailed, instr.ast);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
+    std::span<const HLILOperandSpec> specs =
         HLILOperandSpecsForOperation(instr.operation);
-    int i = 1;
-    for (const HLILOperandSpec& spec : specs) {
+    sol::table out = lua.create_table(static_cast<int>(specs.size()), 0);
+    ArchNameTables names(lua, ArchFor(instr));
+    auto sink = [&](int i, const HLILOperandSpec& spec, sol::object value) {
         sol::table entry = lua.create_table(0, 3);
         entry["name"] = std::string(spec.name ? spec.name : "");
         entry["type"] = std::string(spec.type_tag ? spec.type_tag : "");
-        entry["value"] = HLILOperandToLua(lua, instr, spec);
-        out[i++] = entry;
-    }
-    return out;
+        entry["value"] = std::move(value);
+        out.raw_set(i, entry);
+    };
+    ProjectHLILOperands(lua, instr, names, sink);
+    return cache.Store(out);
 }
 
 namespace {
 
 void AppendHLILPrefixOperands(sol::state_view lua, sol::table& out,
                                 int& idx,
-                                const HighLevelILInstruction& instr) {
+                                const HighLevelILInstruction& instr,
+                                const ArchNameTables& names) {
     sol::table marker = lua.create_table(0, 2);
     marker["operation"] = std::string(EnumToString(instr.operation));
     marker["size"] = static_cast<lua_Integer>(instr.size);
     out[idx++] = marker;
 
-    const std::vector<HLILOperandSpec>& specs =
+    std::span<const HLILOperandSpec> specs =
         HLILOperandSpecsForOperation(instr.operation);
     for (const HLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             HighLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
-            AppendHLILPrefixOperands(lua, out, idx, nested);
-        } else if (tag == "expr_list") {
+            AppendHLILPrefixOperands(lua, out, idx, nested, names);
+        } else if (spec.tag == ILOperandTag::ExprList) {
             auto list = instr.GetRawOperandAsExprList(spec.slot_first);
             for (size_t k = 0; k < list.size(); ++k) {
                 HighLevelILInstruction nested = list[k];
-                AppendHLILPrefixOperands(lua, out, idx, nested);
+                AppendHLILPrefixOperands(lua, out, idx, nested, names);
             }
         } else {
-            out[idx++] = HLILOperandToLua(lua, instr, spec);
+            out[idx++] = HLILOperandToLua(lua, instr, spec, names);
         }
     }
 }
@@ -1039,10 +1202,14 @@ void AppendHLILPrefixOperands(sol::state_view lua, sol::table& out,
 sol::table BuildHLILPrefixOperandsTable(
     sol::this_state ts, const HighLevelILInstruction& instr) {
     sol::state_view lua(ts);
+    OperandTableCache cache(lua, instr.function, instr.exprIndex,
+                            OperandTableCache::Prefix, instr.ast);
+    if (sol::optional<sol::table> hit = cache.Find()) return *hit;
     sol::table out = lua.create_table();
     int idx = 1;
-    AppendHLILPrefixOperands(lua, out, idx, instr);
-    return out;
+    ArchNameTables names(lua, ArchFor(instr));
+    AppendHLILPrefixOperands(lua, out, idx, instr, names);
+    return cache.Store(out);
 }
 
 namespace {
@@ -1058,15 +1225,14 @@ void TraverseHLILRecursive(sol::state_view lua, sol::table& results,
             results[idx++] = result;
         }
     }
-    const std::vector<HLILOperandSpec>& specs =
+    std::span<const HLILOperandSpec> specs =
         HLILOperandSpecsForOperation(instr.operation);
     for (const HLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             HighLevelILInstruction nested =
                 instr.GetRawOperandAsExpr(spec.slot_first);
             TraverseHLILRecursive(lua, results, idx, nested, cb);
-        } else if (tag == "expr_list") {
+        } else if (spec.tag == ILOperandTag::ExprList) {
             auto list = instr.GetRawOperandAsExprList(spec.slot_first);
             for (size_t k = 0; k < list.size(); ++k) {
                 HighLevelILInstruction nested = list[k];
@@ -1096,13 +1262,12 @@ sol::table GetHLILChildren(sol::this_state ts,
     sol::state_view lua(ts);
     sol::table out = lua.create_table();
     int idx = 1;
-    const std::vector<HLILOperandSpec>& specs =
+    std::span<const HLILOperandSpec> specs =
         HLILOperandSpecsForOperation(instr.operation);
     for (const HLILOperandSpec& spec : specs) {
-        const std::string tag = spec.type_tag ? spec.type_tag : "";
-        if (tag == "expr") {
+        if (spec.tag == ILOperandTag::Expr) {
             out[idx++] = instr.GetRawOperandAsExpr(spec.slot_first);
-        } else if (tag == "expr_list") {
+        } else if (spec.tag == ILOperandTag::ExprList) {
             auto list = instr.GetRawOperandAsExprList(spec.slot_first);
             for (size_t k = 0; k < list.size(); ++k) {
                 out[idx++] = list[k];
@@ -0,0 +1,868 @@
+// Sol2 IL pattern-matching bindings for binja-lua
+//
+// Compiles Lua pattern tables into ILPatternNode trees
+// (bindings/il_pattern.h), matches them natively over MLIL / HLIL
+// expression trees, and binds ILPattern.compile plus the match
+// entry points on the IL function and BinaryView usertypes.
+//
+// Pattern vocabulary (all keys optional, all constraints conjunctive):
+//   "_" / true          wildcard
+//   "call"              shorthand for {op = "call"}
+//   0x10                shorthand for {const = 0x10}
+//   op = name | {names} opcode set, short or verbatim ("MLIL_CALL")
+//   capture = "name"    record the matched expression / operand
+//   size = n            expression size in bytes
+//   const = true | n | {min = a, max = b}
+//                       integer constant (const, const_ptr, extern_ptr,
+//                       import) or an int operand
+//   symbol = "memcpy"   constant pointer to a symbol of that name
+//   var = true | "name" variable read / address-of, or a var operand
+//   operands = {dest = p, [2] = p, ...}
+//                       sub-patterns by operand name or position
+//   one_of = {p, ...}   at least one alternative matches
+//   none_of = {p, ...}  no alternative matches
+//   contains = p        some strict descendant matches
+// On an expr_list operand (call params, ...) the sub-pattern instead
+// takes [i] = p element patterns, count = n and some = p.
+
+#include "il_pattern.h"
+
+#include "analysis_index.h"
+
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace BinjaLua {
+
+namespace {
+
+const char* LevelName(ILPattern::Level level) {
+    return level == ILPattern::MLIL ? "mlil" : "hlil";
+}
+
+std::optional<ILPattern::Level> ParseLevel(const std::string& name) {
+    if (name == "mlil") return ILPattern::MLIL;
+    if (name == "hlil") return ILPattern::HLIL;
+    return std::nullopt;
+}
+
+// Table -> ILPatternNode. The first error is kept and reported by
+// ILPattern::Compile.
+class PatternCompiler {
+public:
+    explicit PatternCompiler(ILPattern::Level level) : m_level(level) {}
+
+    const std::string& Error() const { return m_error; }
+
+    std::unique_ptr<ILPatternNode> Compile(const sol::object& spec) {
+        auto node = std::make_unique<ILPatternNode>();
+        switch (spec.get_type()) {
+        case sol::type::boolean:
+            if (!spec.as<bool>()) return Fail("'false' is not a pattern");
+            return node;
+        case sol::type::number:
+            node->constEq = spec.as<lua_Integer>();
+            return node;
+        case sol::type::string: {
+            std::string name = spec.as<std::string>();
+            if (name == "_") return node;
+            if (!AddOperation(*node, name)) return nullptr;
+            return node;
+        }
+        case sol::type::table:
+            break;
+        default:
+            return Fail("pattern must be a table, string, number or true");
+        }
+
+        for (const auto& [key, value] : spec.as<sol::table>()) {
+            if (key.get_type() == sol::type::number) {
+                auto pattern = Compile(value);
+                if (!pattern) return nullptr;
+                lua_Integer pos = key.as<lua_Integer>();
+                if (pos < 1) return Fail("list positions start at 1");
+                node->items.emplace_back(static_cast<size_t>(pos),
+                                         std::move(pattern));
+                continue;
+            }
+            if (key.get_type() != sol::type::string) {
+                return Fail("pattern keys must be strings or positions");
+            }
+            if (!CompileKey(*node, key.as<std::string>(), value)) {
+                return nullptr;
+            }
+        }
+        return node;
+    }
+
+private:
+    std::unique_ptr<ILPatternNode> Fail(std::string message) {
+        if (m_error.empty()) m_error = std::move(message);
+        return nullptr;
+    }
+
+    bool AddOperation(ILPatternNode& node, const std::string& name) {
+        std::optional<size_t> op;
+        if (m_level == ILPattern::MLIL) {
+            if (auto v = EnumFromString<BNMediumLevelILOperation>(name)) {
+                op = static_cast<size_t>(*v);
+            }
+        } else if (auto v = EnumFromString<BNHighLevelILOperation>(name)) {
+            op = static_cast<size_t>(*v);
+        }
+        if (!op) {
+            Fail("unknown " + std::string(LevelName(m_level)) +
+                 " operation '" + name + "'");
+            return false;
+        }
+        node.hasOps = true;
+        node.ops.set(*op);
+        return true;
+    }
+
+    bool CompileList(std::vector<std::unique_ptr<ILPatternNode>>& out,
+                     const std::string& key, const sol::object& value) {
+        if (value.get_type() != sol::type::table) {
+            Fail("'" + key + "' takes a list of patterns");
+            return false;
+        }
+        sol::table list = value.as<sol::table>();
+        for (size_t i = 1, n = list.size(); i <= n; ++i) {
+            auto pattern = Compile(list.raw_get<sol::object>(i));
+            if (!pattern) return false;
+            out.push_back(std::move(pattern));
+        }
+        return true;
+    }
+
+    bool CompileKey(ILPatternNode& node, const std::string& key,
+                    const sol::object& value) {
+        const sol::type type = value.get_type();
+        if (key == "op") {
+            if (type == sol::type::string) {
+                return AddOperation(node, value.as<std::string>());
+            }
+            if (type != sol::type::table) {
+                Fail("'op' takes a name or a list of names");
+                return false;
+            }
+            sol::table names = value.as<sol::table>();
+            for (size_t i = 1, n = names.size(); i <= n; ++i) {
+                auto name = names.raw_get<sol::optional<std::string>>(i);
+                if (!name || !AddOperation(node, *name)) {
+                    if (name) return false;
+                    Fail("'op' list entries must be strings");
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (key == "capture") {
+            if (type != sol::type::string) {
+                Fail("'capture' takes a name");
+                return false;
+            }
+            node.capture = value.as<std::string>();
+            return true;
+        }
+        if (key == "size" || key == "count") {
+            if (type != sol::type::number) {
+                Fail("'" + key + "' takes an integer");
+                return false;
+            }
+            auto n = static_cast<size_t>(value.as<lua_Integer>());
+            (key == "size" ? node.size : node.count) = n;
+            return true;
+        }
+        if (key == "const") {
+            if (type == sol::type::boolean && value.as<bool>()) {
+                node.anyConst = true;
+            } else if (type == sol::type::number) {
+                node.constEq = value.as<lua_Integer>();
+            } else if (type == sol::type::table) {
+                sol::table range = value.as<sol::table>();
+                node.anyConst = true;
+                if (auto lo = range.get<sol::optional<lua_Integer>>("min")) {
+                    node.constMin = *lo;
+                }
+                if (auto hi = range.get<sol::optional<lua_Integer>>("max")) {
+                    node.constMax = *hi;
+                }
+            } else {
+                Fail("'const' takes true, an integer or {min, max}");
+                return false;
+            }
+            return true;
+        }
+        if (key == "symbol") {
+            if (type != sol::type::string) {
+                Fail("'symbol' takes a name");
+                return false;
+            }
+            node.symbol = value.as<std::string>();
+            return true;
+        }
+        if (key == "var") {
+            if (type == sol::type::boolean && value.as<bool>()) {
+                node.anyVar = true;
+            } else if (type == sol::type::string) {
+                node.varName = value.as<std::string>();
+            } else {
+                Fail("'var' takes true or a variable name");
+                return false;
+            }
+            return true;
+        }
+        if (key == "operands") {
+            if (type != sol::type::table) {
+                Fail("'operands' takes a table");
+                return false;
+            }
+            for (const auto& [k, v] : value.as<sol::table>()) {
+                ILPatternNode::Operand operand;
+                if (k.get_type() == sol::type::string) {
+                    operand.name = k.as<std::string>();
+                } else if (k.get_type() == sol::type::number &&
+                           k.as<lua_Integer>() >= 1) {
+                    operand.position = static_cast<size_t>(k.as<lua_Integer>());
+                } else {
+                    Fail("'operands' keys must be names or positions");
+                    return false;
+                }
+                operand.pattern = Compile(v);
+                if (!operand.pattern) return false;
+                node.operands.push_back(std::move(operand));
+            }
+            return true;
+        }
+        if (key == "one_of") return CompileList(node.oneOf, key, value);
+        if (key == "none_of") return CompileList(node.noneOf, key, value);
+        if (key == "contains" || key == "some") {
+            auto pattern = Compile(value);
+            if (!pattern) return false;
+            (key == "contains" ? node.contains : node.some) =
+                std::move(pattern);
+            return true;
+        }
+        Fail("unknown pattern key '" + key + "'");
+        return false;
+    }
+
+    ILPattern::Level m_level;
+    std::string m_error;
+};
+
+// Per-family hooks the matcher needs beyond the common instruction
+// interface.
+template <typename Instr>
+struct ILPatternFamily;
+
+template <>
+struct ILPatternFamily<MediumLevelILInstruction> {
+    using Spec = MLILOperandSpec;
+
+    static std::span<const Spec> Specs(const MediumLevelILInstruction& i) {
+        return MLILOperandSpecsForOperation(i.operation);
+    }
+
+    static std::optional<int64_t> ConstValue(
+        const MediumLevelILInstruction& i) {
+        switch (i.operation) {
+        case MLIL_CONST:
+        case MLIL_CONST_PTR:
+        case MLIL_EXTERN_PTR:
+        case MLIL_IMPORT:
+            return static_cast<int64_t>(i.GetRawOperandAsInteger(0));
+        default:
+            return std::nullopt;
+        }
+    }
+
+    static std::optional<Variable> VarOf(const MediumLevelILInstruction& i) {
+        switch (i.operation) {
+        case MLIL_VAR:
+        case MLIL_VAR_FIELD:
+        case MLIL_ADDRESS_OF:
+        case MLIL_ADDRESS_OF_FIELD:
+            return i.GetRawOperandAsVariable(0);
+        case MLIL_VAR_SSA:
+        case MLIL_VAR_SSA_FIELD:
+        case MLIL_VAR_ALIASED:
+        case MLIL_VAR_ALIASED_FIELD:
+            return i.GetRawOperandAsSSAVariable(0).var;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    static sol::object OperandToLua(sol::state_view lua,
+                                    const MediumLevelILInstruction& i,
+                                    const Spec& spec,
+                                    const ArchNameTables& names) {
+        return MLILOperandToLua(lua, i, spec, names);
+    }
+};
+
+template <>
+struct ILPatternFamily<HighLevelILInstruction> {
+    using Spec = HLILOperandSpec;
+
+    static std::span<const Spec> Specs(const HighLevelILInstruction& i) {
+        return HLILOperandSpecsForOperation(i.operation);
+    }
+
+    static std::optional<int64_t> ConstValue(const HighLevelILInstruction& i) {
+        switch (i.operation) {
+        case HLIL_CONST:
+        case HLIL_CONST_PTR:
+        case HLIL_EXTERN_PTR:
+        case HLIL_IMPORT:
+            return static_cast<int64_t>(i.GetRawOperandAsInteger(0));
+        default:
+            return std::nullopt;
+        }
+    }
+
+    static std::optional<Variable> VarOf(const HighLevelILInstruction& i) {
+        switch (i.operation) {
+        case HLIL_VAR:
+            return i.GetRawOperandAsVariable(0);
+        case HLIL_VAR_SSA:
+            return i.GetRawOperandAsSSAVariable(0).var;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    static sol::object OperandToLua(sol::state_view lua,
+                                    const HighLevelILInstruction& i,
+                                    const Spec& spec,
+                                    const ArchNameTables& names) {
+        return HLILOperandToLua(lua, i, spec, names);
+    }
+};
+
+// Matches one compiled pattern against expressions of one function.
+// Captures are appended to `caps` and rolled back on failure, so a
+// failed alternative leaves no trace.
+template <typename Instr>
+class PatternMatcher {
+public:
+    using Family = ILPatternFamily<Instr>;
+    using Spec = typename Family::Spec;
+    using Captures = std::vector<ILPatternCapture>;
+
+    explicit PatternMatcher(Ref<Function> func)
+        : m_func(std::move(func)),
+          m_view(m_func ? m_func->GetView() : Ref<BinaryView>()) {}
+
+    bool Match(const ILPatternNode& p, const Instr& instr, Captures& caps) {
+        const size_t mark = caps.size();
+        if (!MatchExpr(p, instr, caps)) {
+            caps.resize(mark);
+            return false;
+        }
+        if (!p.capture.empty()) {
+            caps.push_back({&p.capture, instr.exprIndex, -1});
+        }
+        return true;
+    }
+
+private:
+    // one_of / none_of over any of the three operand shapes.
+    template <typename Test>
+    bool MatchAlternatives(const ILPatternNode& p, Captures& caps,
+                           Test&& test) {
+        for (const auto& alt : p.noneOf) {
+            const size_t mark = caps.size();
+            bool hit = test(*alt);
+            caps.resize(mark);
+            if (hit) return false;
+        }
+        if (p.oneOf.empty()) return true;
+        for (const auto& alt : p.oneOf) {
+            if (test(*alt)) return true;
+        }
+        return false;
+    }
+
+    bool MatchExpr(const ILPatternNode& p, const Instr& instr,
+                   Captures& caps) {
+        if (p.hasOps && !p.ops.test(static_cast<size_t>(instr.operation))) {
+            return false;
+        }
+        if (p.size && instr.size != *p.size) return false;
+        if (p.HasConstConstraints() || p.symbol) {
+            std::optional<int64_t> value = Family::ConstValue(instr);
+            if (!value || !ConstMatches(p, *value)) return false;
+            if (p.symbol &&
+                !SymbolIs(static_cast<uint64_t>(*value), *p.symbol)) {
+                return false;
+            }
+        }
+        if (p.HasVarConstraints() && !VarMatches(p, Family::VarOf(instr))) {
+            return false;
+        }
+        if (!p.operands.empty()) {
+            std::span<const Spec> specs = Family::Specs(instr);
+            for (const auto& operand : p.operands) {
+                std::optional<size_t> index = FindOperand(specs, operand);
+                if (!index ||
+                    !MatchOperand(*operand.pattern, instr, specs, *index,
+                                  caps)) {
+                    return false;
+                }
+            }
+        }
+        if (p.contains && !MatchDescendant(*p.contains, instr, caps)) {
+            return false;
+        }
+        return MatchAlternatives(p, caps, [&](const ILPatternNode& alt) {
+            return Match(alt, instr, caps);
+        });
+    }
+
+    bool MatchOperand(const ILPatternNode& p, const Instr& instr,
+                      std::span<const Spec> specs, size_t index,
+                      Captures& caps) {
+        const Spec& spec = specs[index];
+        if (spec.tag == ILOperandTag::Expr) {
+            return Match(p, instr.GetRawOperandAsExpr(spec.slot_first), caps);
+        }
+        const size_t mark = caps.size();
+        bool ok = spec.tag == ILOperandTag::ExprList
+                      ? MatchList(p, instr, spec, caps)
+                      : MatchScalar(p, instr, spec, caps);
+        if (!ok) {
+            caps.resize(mark);
+            return false;
+        }
+        if (!p.capture.empty()) {
+            caps.push_back({&p.capture, instr.exprIndex,
+                            static_cast<int>(index)});
+        }
+        return true;
+    }
+
+    bool MatchList(const ILPatternNode& p, const Instr& instr,
+                   const Spec& spec, Captures& caps) {
+        if (p.HasExprConstraints() || p.HasConstConstraints() ||
+            p.HasVarConstraints()) {
+            return false;
+        }
+        std::vector<Instr> elements;
+        for (auto element : instr.GetRawOperandAsExprList(spec.slot_first)) {
+            elements.push_back(element);
+        }
+        if (p.count && elements.size() != *p.count) return false;
+        for (const auto& [pos, item] : p.items) {
+            if (pos > elements.size() ||
+                !Match(*item, elements[pos - 1], caps)) {
+                return false;
+            }
+        }
+        if (p.some) {
+            bool any = false;
+            for (const Instr& element : elements) {
+                if (Match(*p.some, element, caps)) {
+                    any = true;
+                    break;
+                }
+            }
+            if (!any) return false;
+        }
+        return MatchAlternatives(p, caps, [&](const ILPatternNode& alt) {
+            const size_t mark = caps.size();
+            if (MatchList(alt, instr, spec, caps)) return true;
+            caps.resize(mark);
+            return false;
+        });
+    }
+
+    bool MatchScalar(const ILPatternNode& p, const Instr& instr,
+                     const Spec& spec, Captures& caps) {
+        if (p.HasExprConstraints() || !p.items.empty() || p.count ||
+            p.some) {
+            return false;
+        }
+        const size_t slot = spec.slot_first;
+        if (p.HasConstConstraints()) {
+            if (spec.tag != ILOperandTag::Int ||
+                !ConstMatches(p, static_cast<int64_t>(
+                                     instr.GetRawOperandAsInteger(slot)))) {
+                return false;
+            }
+        }
+        if (p.HasVarConstraints()) {
+            std::optional<Variable> var;
+            if (spec.tag == ILOperandTag::Var) {
+                var = instr.GetRawOperandAsVariable(slot);
+            } else if (spec.tag == ILOperandTag::VarSSA) {
+                var = instr.GetRawOperandAsSSAVariable(slot).var;
+            }
+            if (!VarMatches(p, var)) return false;
+        }
+        return MatchAlternatives(p, caps, [&](const ILPatternNode& alt) {
+            return MatchScalar(alt, instr, spec, caps);
+        });
+    }
+
+    bool MatchDescendant(const ILPatternNode& p, const Instr& instr,
+                         Captures& caps) {
+        bool found = false;
+        auto visit = [&](const Instr& expr) -> bool {
+            if (!found && Match(p, expr, caps)) found = true;
+            return !found;
+        };
+        for (const Spec& spec : Family::Specs(instr)) {
+            if (found) break;
+            if (spec.tag == ILOperandTag::Expr) {
+                instr.GetRawOperandAsExpr(spec.slot_first).VisitExprs(visit);
+            } else if (spec.tag == ILOperandTag::ExprList) {
+                for (auto child :
+                     instr.GetRawOperandAsExprList(spec.slot_first)) {
+                    if (found) break;
+                    child.VisitExprs(visit);
+                }
+            }
+        }
+        return found;
+    }
+
+    static std::optional<size_t> FindOperand(
+        std::span<const Spec> specs, const ILPatternNode::Operand& operand) {
+        if (operand.position) {
+            if (operand.position > specs.size()) return std::nullopt;
+            return operand.position - 1;
+        }
+        for (size_t i = 0; i < specs.size(); ++i) {
+            if (specs[i].name && operand.name == specs[i].name) return i;
+        }
+        return std::nullopt;
+    }
+
+    static bool ConstMatches(const ILPatternNode& p, int64_t value) {
+        if (p.constEq && value != *p.constEq) return false;
+        if (p.constMin && value < *p.constMin) return false;
+        if (p.constMax && value > *p.constMax) return false;
+        return true;
+    }
+
+    bool VarMatches(const ILPatternNode& p, const std::optional<Variable>& var) {
+        if (!var) return false;
+        if (!p.varName) return true;
+        return m_func && m_func->GetVariableNameOrDefault(*var) == *p.varName;
+    }
+
+    bool SymbolIs(uint64_t address, const std::string& name) {
+        if (!m_view) return false;
+        auto it = m_symbols.find(address);
+        if (it == m_symbols.end()) {
+            it = m_symbols.emplace(address, m_view->GetSymbolByAddress(address))
+                     .first;
+        }
+        const Ref<Symbol>& sym = it->second;
+        return sym && (sym->GetShortName() == name ||
+                       sym->GetFullName() == name ||
+                       sym->GetRawName() == name);
+    }
+
+    Ref<Function> m_func;
+    Ref<BinaryView> m_view;
+    std::unordered_map<uint64_t, Ref<Symbol>> m_symbols;
+};
+
+template <typename Instr>
+std::optional<ILPatternMatch> MatchOne(const ILPatternNode& root,
+                                       const Instr& instr) {
+    Ref<Function> func =
+        instr.function ? instr.function->GetFunction() : Ref<Function>();
+    PatternMatcher<Instr> matcher(func);
+    ILPatternMatch match{instr.exprIndex, {}};
+    if (!matcher.Match(root, instr, match.captures)) return std::nullopt;
+    return match;
+}
+
+// Try the pattern at every node under `tree` in pre-order.
+template <typename Instr>
+void CollectMatches(PatternMatcher<Instr>& matcher, const ILPatternNode& root,
+                    const Instr& tree, std::vector<ILPatternMatch>& out) {
+    tree.VisitExprs([&](const Instr& expr) -> bool {
+        std::vector<ILPatternCapture> caps;
+        if (matcher.Match(root, expr, caps)) {
+            out.push_back({expr.exprIndex, std::move(caps)});
+        }
+        return true;
+    });
+}
+
+// {name = value} for one match. Expression captures become instruction
+// usertypes; operand captures are projected like operands().
+template <typename Instr, typename IL>
+sol::table CapturesToLua(sol::state_view lua, IL& il,
+                         const ILPatternMatch& match,
+                         const ArchNameTables& names) {
+    using Family = ILPatternFamily<Instr>;
+    sol::table caps = lua.create_table(0, static_cast<int>(match.captures.size()));
+    for (const ILPatternCapture& c : match.captures) {
+        Instr instr = il.GetExpr(c.exprIndex);
+        if (c.operand < 0) {
+            caps[*c.name] = instr;
+        } else {
+            caps[*c.name] = Family::OperandToLua(
+                lua, instr, Family::Specs(instr)[c.operand], names);
+        }
+    }
+    return caps;
+}
+
+template <typename Instr, typename IL>
+void MatchesToLua(sol::state_view lua, IL& il,
+                  const std::vector<ILPatternMatch>& matches,
+                  const Ref<Function>& func, sol::table& out, int& idx) {
+    ArchNameTables names(lua, func ? func->GetArchitecture()
+                                   : Ref<Architecture>());
+    for (const ILPatternMatch& match : matches) {
+        Instr instr = il.GetExpr(match.exprIndex);
+        sol::table record = lua.create_table(0, 4);
+        if (func) record["func"] = func;
+        record["address"] = static_cast<lua_Integer>(instr.address);
+        record["instr"] = instr;
+        record["captures"] = CapturesToLua<Instr>(lua, il, match, names);
+        out[idx++] = record;
+    }
+}
+
+// A compiled ILPattern of the right level, or a pattern table compiled
+// on the spot. Null (after a warning) otherwise.
+std::shared_ptr<ILPattern> ResolvePattern(sol::state_view lua,
+                                          const char* caller,
+                                          ILPattern::Level level,
+                                          const sol::object& pattern) {
+    if (pattern.is<ILPattern>()) {
+        auto compiled = pattern.as<std::shared_ptr<ILPattern>>();
+        if (compiled->GetLevel() != level) {
+            if (Ref<Logger> logger = GetLogger(lua)) {
+                logger->LogWarn("%s: pattern was compiled for %s, not %s",
+                                caller, LevelName(compiled->GetLevel()),
+                                LevelName(level));
+            }
+            return nullptr;
+        }
+        return compiled;
+    }
+    return ILPattern::Compile(lua, caller, level, pattern);
+}
+
+template <typename IL>
+Ref<IL> FormFor(IL& il, const sol::optional<sol::table>& opts) {
+    if (opts && opts->get_or("ssa", false)) return il.GetSSAForm();
+    return Ref<IL>(&il);
+}
+
+template <typename Instr, typename IL>
+sol::object FunctionMatch(sol::this_state ts, IL& il, ILPattern::Level level,
+                          const sol::object& pattern,
+                          const sol::optional<sol::table>& opts) {
+    sol::state_view lua(ts);
+    std::shared_ptr<ILPattern> compiled =
+        ResolvePattern(lua, "match", level, pattern);
+    if (!compiled) return sol::make_object(lua, sol::nil);
+    sol::table out = lua.create_table();
+    Ref<IL> form = FormFor(il, opts);
+    if (!form) return sol::make_object(lua, out);
+    int idx = 1;
+    MatchesToLua<Instr>(lua, *form, compiled->FindAll(*form),
+                        form->GetFunction(), out, idx);
+    return sol::make_object(lua, out);
+}
+
+template <typename Instr>
+sol::object PatternMatchAt(sol::this_state ts, const ILPattern& pattern,
+                           const Instr& instr) {
+    sol::state_view lua(ts);
+    const ILPattern::Level level =
+        std::is_same_v<Instr, MediumLevelILInstruction> ? ILPattern::MLIL
+                                                        : ILPattern::HLIL;
+    if (pattern.GetLevel() != level || !instr.function) {
+        return sol::make_object(lua, sol::nil);
+    }
+    std::optional<ILPatternMatch> match = pattern.MatchAt(instr);
+    if (!match) return sol::make_object(lua, sol::nil);
+    Ref<Function> func = instr.function->GetFunction();
+    ArchNameTables names(lua, func ? func->GetArchitecture()
+                                   : Ref<Architecture>());
+    return sol::make_object(
+        lua, CapturesToLua<Instr>(lua, *instr.function, *match, names));
+}
+
+}  // namespace
+
+std::shared_ptr<ILPattern> ILPattern::Compile(sol::state_view lua,
+                                              const char* caller,
+                                              Level level,
+                                              const sol::object& spec) {
+    PatternCompiler compiler(level);
+    std::unique_ptr<ILPatternNode> root = compiler.Compile(spec);
+    if (!root) {
+        if (Ref<Logger> logger = GetLogger(lua)) {
+            logger->LogWarn("%s: %s", caller, compiler.Error().c_str());
+        }
+        return nullptr;
+    }
+    return std::shared_ptr<ILPattern>(new ILPattern(level, std::move(root)));
+}
+
+std::vector<ILPatternMatch> ILPattern::FindAll(
+    MediumLevelILFunction& il) const {
+    std::vector<ILPatternMatch> out;
+    PatternMatcher<MediumLevelILInstruction> matcher(il.GetFunction());
+    const size_t count = il.GetInstructionCount();
+    for (size_t i = 0; i < count; ++i) {
+        CollectMatches(matcher, *m_root, il.GetInstruction(i), out);
+    }
+    return out;
+}
+
+std::vector<ILPatternMatch> ILPattern::FindAll(
+    HighLevelILFunction& il) const {
+    // HLIL statements nest, so walk the one tree from the root rather
+    // than every instruction (which would visit nested bodies twice).
+    std::vector<ILPatternMatch> out;
+    if (il.GetInstructionCount() == 0) return out;
+    PatternMatcher<HighLevelILInstruction> matcher(il.GetFunction());
+    CollectMatches(matcher, *m_root, il.GetRootExpr(), out);
+    return out;
+}
+
+std::optional<ILPatternMatch> ILPattern::MatchAt(
+    const MediumLevelILInstruction& instr) const {
+    return MatchOne(*m_root, instr);
+}
+
+std::optional<ILPatternMatch> ILPattern::MatchAt(
+    const HighLevelILInstruction& instr) const {
+    return MatchOne(*m_root, instr);
+}
+
+sol::object MLILFunctionMatch(sol::this_state ts, MediumLevelILFunction& il,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts) {
+    return FunctionMatch<MediumLevelILInstruction>(ts, il, ILPattern::MLIL,
+                                                   pattern, opts);
+}
+
+sol::object HLILFunctionMatch(sol::this_state ts, HighLevelILFunction& il,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts) {
+    return FunctionMatch<HighLevelILInstruction>(ts, il, ILPattern::HLIL,
+                                                 pattern, opts);
+}
+
+// bv:match_il(pattern [, opts]). Matching fans out over functions on
+// the worker pool; only the matches are projected to Lua afterwards.
+sol::object BinaryViewMatchIL(sol::this_state ts, BinaryView& bv,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts) {
+    sol::state_view lua(ts);
+    std::optional<ILPattern::Level> level;
+    if (pattern.is<ILPattern>()) {
+        level = pattern.as<const ILPattern&>().GetLevel();
+    } else {
+        std::string name = opts ? opts->get_or<std::string>("level", "mlil")
+                                : std::string("mlil");
+        level = ParseLevel(name);
+        if (!level) {
+            if (Ref<Logger> logger = GetLogger(lua)) {
+                logger->LogWarn("match_il: unknown level '%s'", name.c_str());
+            }
+            return sol::make_object(lua, sol::nil);
+        }
+    }
+    std::shared_ptr<ILPattern> compiled =
+        ResolvePattern(lua, "match_il", *level, pattern);
+    if (!compiled) return sol::make_object(lua, sol::nil);
+
+    const bool ssa = opts ? opts->get_or("ssa", false) : false;
+    const size_t workers = opts ? opts->get_or<size_t>("workers", 0) : 0;
+
+    std::vector<Ref<Function>> funcs = bv.GetAnalysisFunctionList();
+    std::vector<Ref<MediumLevelILFunction>> mlil(
+        *level == ILPattern::MLIL ? funcs.size() : 0);
+    std::vector<Ref<HighLevelILFunction>> hlil(
+        *level == ILPattern::HLIL ? funcs.size() : 0);
+    std::vector<std::vector<ILPatternMatch>> matches(funcs.size());
+    ParallelFor(funcs.size(), [&](size_t i) {
+        if (*level == ILPattern::MLIL) {
+            Ref<MediumLevelILFunction> il = funcs[i]->GetMediumLevelIL();
+            if (il && ssa) il = il->GetSSAForm();
+            if (!il) return;
+            matches[i] = compiled->FindAll(*il);
+            mlil[i] = il;
+        } else {
+            Ref<HighLevelILFunction> il = funcs[i]->GetHighLevelIL();
+            if (il && ssa) il = il->GetSSAForm();
+            if (!il) return;
+            matches[i] = compiled->FindAll(*il);
+            hlil[i] = il;
+        }
+    }, workers);
+
+    sol::table out = lua.create_table();
+    int idx = 1;
+    for (size_t i = 0; i < funcs.size(); ++i) {
+        if (matches[i].empty()) continue;
+        if (*level == ILPattern::MLIL) {
+            MatchesToLua<MediumLevelILInstruction>(lua, *mlil[i], matches[i],
+                                                   funcs[i], out, idx);
+        } else {
+            MatchesToLua<HighLevelILInstruction>(lua, *hlil[i], matches[i],
+                                                 funcs[i], out, idx);
+        }
+    }
+    return sol::make_object(lua, out);
+}
+
+void RegisterILPatternBindings(sol::state_view lua, Ref<Logger> logger) {
+    if (logger) logger->LogDebug("Registering ILPattern bindings");
+
+    lua.new_usertype<ILPattern>(ILPATTERN_METATABLE,
+        sol::no_constructor,
+
+        "level", sol::property([](const ILPattern& p) -> std::string {
+            return LevelName(p.GetLevel());
+        }),
+
+        // Captures table when the pattern matches at exactly this
+        // expression, nil otherwise (or for an instruction of the
+        // other IL level).
+        "match", sol::overload(&PatternMatchAt<MediumLevelILInstruction>,
+                               &PatternMatchAt<HighLevelILInstruction>),
+
+        sol::meta_function::to_string, [](const ILPattern& p) -> std::string {
+            return fmt::format("<ILPattern: {}>", LevelName(p.GetLevel()));
+        }
+    );
+
+    lua["ILPattern"] = lua.create_table_with(
+        "compile", [](sol::this_state ts, const std::string& level,
+                      sol::object spec) -> std::shared_ptr<ILPattern> {
+            sol::state_view lua(ts);
+            std::optional<ILPattern::Level> parsed = ParseLevel(level);
+            if (!parsed) {
+                if (Ref<Logger> logger = GetLogger(lua)) {
+                    logger->LogWarn("ILPattern.compile: unknown level '%s'",
+                                    level.c_str());
+                }
+                return nullptr;
+            }
+            return ILPattern::Compile(lua, "ILPattern.compile", *parsed, spec);
+        }
+    );
+
+    if (logger) logger->LogDebug("ILPattern bindings registered");
+}
+
+}  // namespace BinjaLua
@@ -0,0 +1,132 @@
+// Compiled IL tree patterns for binja-lua.
+//
+// A pattern is a Lua table (see ILPattern::Compile) compiled once into
+// an ILPatternNode tree, then matched natively against MLIL / HLIL
+// expression trees: operands are reached through the generated
+// *OperandSpecsForOperation tables and raw slot reads, so no operand
+// tables are built while matching. Captures are recorded as expression
+// / operand indices and only projected to Lua values for the matches
+// that are returned.
+//
+// Compiled patterns are immutable and matching only makes core calls,
+// so one pattern can be shared by ParallelFor workers.
+
+#pragma once
+
+#include "common.h"
+#include "il.h"
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BinjaLua {
+
+struct ILPatternNode {
+    // Where a sub-pattern is attached on its parent: an operand name
+    // ("dest", "params", ...) or a 1-based position in the operand
+    // list.
+    struct Operand {
+        std::string name;
+        size_t position = 0;
+        std::unique_ptr<ILPatternNode> pattern;
+    };
+
+    std::string capture;
+
+    // Expression constraints, all of which must hold.
+    bool hasOps = false;
+    std::bitset<256> ops;
+    std::optional<size_t> size;
+    bool anyConst = false;
+    std::optional<int64_t> constEq;
+    std::optional<int64_t> constMin;
+    std::optional<int64_t> constMax;
+    std::optional<std::string> symbol;
+    bool anyVar = false;
+    std::optional<std::string> varName;
+    std::vector<Operand> operands;
+    std::vector<std::unique_ptr<ILPatternNode>> oneOf;
+    std::vector<std::unique_ptr<ILPatternNode>> noneOf;
+    std::unique_ptr<ILPatternNode> contains;
+
+    // Applied instead when the pattern lands on an expr_list operand:
+    // positional element patterns (1-based), an exact length and a
+    // "some element matches" pattern.
+    std::vector<std::pair<size_t, std::unique_ptr<ILPatternNode>>> items;
+    std::optional<size_t> count;
+    std::unique_ptr<ILPatternNode> some;
+
+    // Constraints that only make sense on an expression (as opposed
+    // to a scalar or list operand).
+    bool HasExprConstraints() const {
+        return hasOps || size || symbol || !operands.empty() || contains;
+    }
+    bool HasConstConstraints() const {
+        return anyConst || constEq || constMin || constMax;
+    }
+    bool HasVarConstraints() const { return anyVar || varName.has_value(); }
+};
+
+// One captured value: the expression at exprIndex, or (operand >= 0)
+// the operand at that spec position of the expression at exprIndex.
+struct ILPatternCapture {
+    const std::string* name;
+    size_t exprIndex;
+    int operand;
+};
+
+struct ILPatternMatch {
+    size_t exprIndex;
+    std::vector<ILPatternCapture> captures;
+};
+
+class ILPattern {
+public:
+    enum Level { MLIL, HLIL };
+
+    // Compile a pattern table for one IL level. Returns null (after
+    // logging a warning naming the caller) on a malformed pattern.
+    static std::shared_ptr<ILPattern> Compile(sol::state_view lua,
+                                              const char* caller,
+                                              Level level,
+                                              const sol::object& spec);
+
+    Level GetLevel() const { return m_level; }
+    const ILPatternNode& Root() const { return *m_root; }
+
+    // Every match in one IL function, in tree pre-order per
+    // instruction (MLIL) or from the root statement (HLIL). Worker-
+    // safe.
+    std::vector<ILPatternMatch> FindAll(MediumLevelILFunction& il) const;
+    std::vector<ILPatternMatch> FindAll(HighLevelILFunction& il) const;
+
+    // Match at one expression only.
+    std::optional<ILPatternMatch> MatchAt(
+        const MediumLevelILInstruction& instr) const;
+    std::optional<ILPatternMatch> MatchAt(
+        const HighLevelILInstruction& instr) const;
+
+private:
+    ILPattern(Level level, std::unique_ptr<ILPatternNode> root)
+        : m_level(level), m_root(std::move(root)) {}
+
+    Level m_level;
+    std::unique_ptr<ILPatternNode> m_root;
+};
+
+// Lua-facing entry points.
+sol::object MLILFunctionMatch(sol::this_state ts, MediumLevelILFunction& il,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts);
+sol::object HLILFunctionMatch(sol::this_state ts, HighLevelILFunction& il,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts);
+sol::object BinaryViewMatchIL(sol::this_state ts, BinaryView& bv,
+                              sol::object pattern,
+                              sol::optional<sol::table> opts);
+
+}  // namespace BinjaLua
@@ -21,6 +21,8 @@ local connectivity = bv:analyze():connectivity_report()
 local size_stats = bv:analyze():size_analysis()
 ]]
 
+local utils = require('utils')
+
 local fluent = {}
 
 --[[
@@ -95,10 +97,24 @@ end
 local main_funcs = bv:query():functions():with_name("main.*"):get()
 ]]
 function Query:with_name(pattern)
+    local bv = self.bv
     table.insert(self.steps, function(data)
+        -- Narrow with the native name index when the pattern carries a
+        -- usable literal; only its hits are pattern-matched in Lua.
+        local allowed
+        local literal = utils.pattern_literal(pattern)
+        if #literal >= 3 then
+            allowed = {}
+            for _, func in ipairs(bv:lookup_functions({contains = literal})) do
+                allowed[func.start_addr.value] = true
+            end
+        end
+
         local results = {}
         for _, item in ipairs(data) do
-            if string.match(item.name, pattern) then
+            local start = allowed and item.start_addr
+            if (not start or allowed[start.value])
+                and string.match(item.name, pattern) then
                 table.insert(results, item)
             end
         end
@@ -249,10 +265,14 @@ end
 local thunks = bv:query():functions():thunks_only():get()
 ]]
 function Query:thunks_only()
+    local bv = self.bv
     table.insert(self.steps, function(data)
+        -- One batched summary lookup instead of an LLIL fetch per item
+        local summaries = bv:function_summaries(data)
         local results = {}
-        for _, item in ipairs(data) do
-            if item.is_thunk then
+        for i, item in ipairs(data) do
+            local s = summaries[i]
+            if s and s.is_thunk then
                 table.insert(results, item)
             end
         end
@@ -269,10 +289,14 @@ end
 local real_funcs = bv:query():functions():exclude_thunks():get()
 ]]
 function Query:exclude_thunks()
+    local bv = self.bv
     table.insert(self.steps, function(data)
+        -- One batched summary lookup instead of an LLIL fetch per item
+        local summaries = bv:function_summaries(data)
         local results = {}
-        for _, item in ipairs(data) do
-            if not item.is_thunk then
+        for i, item in ipairs(data) do
+            local s = summaries[i]
+            if not (s and s.is_thunk) then
                 table.insert(results, item)
             end
         end
@@ -505,7 +529,10 @@ end
 
 -- Connectivity analysis
 function Analysis:connectivity_report()
-    local functions = self.bv:functions()
+    -- Call-site counts come straight from the native call graph
+    -- instead of materialising calls() / callers() per function.
+    local graph = self.bv:call_graph()
+    local functions = graph:functions()
     local stats = {
         total_functions = #functions,
         most_connected = nil,
@@ -518,10 +545,9 @@ function Analysis:connectivity_report()
     local max_connectivity = 0
     local max_callers = 0
     
-    for _, func in ipairs(functions) do
-        local calls = func:calls() or {}
-        local callers = func:callers() or {}
-        local connectivity = #calls + #callers
+    for i, func in ipairs(functions) do
+        local callers = graph:in_sites(i)
+        local connectivity = graph:out_sites(i) + callers
         
         total_connectivity = total_connectivity + connectivity
         
@@ -530,8 +556,8 @@ function Analysis:connectivity_report()
             stats.most_connected = func
         end
         
-        if #callers > max_callers then
-            max_callers = #callers
+        if callers > max_callers then
+            max_callers = callers
             stats.most_called = func
         end
         
@@ -609,6 +635,7 @@ print("Auto-discovered:", class.auto_discovered)
 ]]
 function Analysis:function_classification()
     local functions = self.bv:functions()
+    local summaries = self.bv:function_summaries(functions)
     local stats = {
         total_functions = #functions,
         exported = 0,
@@ -625,8 +652,9 @@ function Analysis:function_classification()
         pure_list = {}
     }
 
-    for _, func in ipairs(functions) do
-        if func.is_exported then
+    for i, func in ipairs(functions) do
+        local summary = summaries[i]
+        if summary.is_exported then
             stats.exported = stats.exported + 1
             table.insert(stats.exported_list, func)
         end
@@ -637,7 +665,7 @@ function Analysis:function_classification()
             stats.user_defined = stats.user_defined + 1
         end
 
-        if func.is_thunk then
+        if summary.is_thunk then
             stats.thunks = stats.thunks + 1
             table.insert(stats.thunk_list, func)
         end
@@ -23,9 +23,59 @@ local depth = utils.get_call_depth(func)
 
 local utils = {}
 
+--[[
+@luaapi utils.pattern_literal(pattern)
+@description Longest plain substring that every match of a Lua pattern must contain
+@param pattern string Lua pattern
+@return string Required literal, or "" when none can be derived
+@example
+print(utils.pattern_literal("^sub_%x+crypt"))  -- "crypt"
+]]
+function utils.pattern_literal(pattern)
+    local best, run = "", {}
+    local function flush()
+        local s = table.concat(run)
+        if #s > #best then best = s end
+        run = {}
+    end
+
+    local i, n = 1, #pattern
+    while i <= n do
+        local c = pattern:sub(i, i)
+        local lit, step = nil, 1
+        if c == "%" then
+            local nx = pattern:sub(i + 1, i + 1)
+            if nx:match("%w") then
+                -- Character class; %bxy also consumes its delimiters.
+                step = nx == "b" and 4 or 2
+            else
+                lit, step = nx, 2
+            end
+        elseif c == "[" then
+            local j = i + 1
+            if pattern:sub(j, j) == "^" then j = j + 1 end
+            if pattern:sub(j, j) == "]" then j = j + 1 end
+            while j <= n and pattern:sub(j, j) ~= "]" do
+                if pattern:sub(j, j) == "%" then j = j + 1 end
+                j = j + 1
+            end
+            step = j - i + 1
+        elseif not c:match("[%^%$%(%)%.%*%+%-%?]") then
+            lit = c
+        end
+        -- An atom followed by *, - or ? may be absent.
+        local q = pattern:sub(i + step, i + step)
+        if lit and (q == "*" or q == "-" or q == "?") then lit = nil end
+        if lit then run[#run + 1] = lit else flush() end
+        i = i + step
+    end
+    flush()
+    return best
+end
+
 --[[
 @luaapi utils.find_functions_by_name_pattern(bv, pattern)
-@description Find all functions whose names match a Lua pattern
+@description Find all functions whose names match a Lua pattern (candidates come from bv:lookup_functions when the pattern has a literal of 3+ characters)
 @param bv BinaryView The binary view to search
 @param pattern string Lua pattern to match against function names
 @return table Array of Function objects matching the pattern
@@ -37,6 +87,16 @@ end
 ]]
 function utils.find_functions_by_name_pattern(bv, pattern)
     local matching_funcs = {}
+    local literal = utils.pattern_literal(pattern)
+    if #literal >= 3 then
+        for _, func in ipairs(bv:lookup_functions({contains = literal})) do
+            if func.name:match(pattern) then
+                table.insert(matching_funcs, func)
+            end
+        end
+        return matching_funcs
+    end
+
     for func in bv:each_function() do
         local name = func.name
         if name and name:match(pattern) then
@@ -70,33 +130,18 @@ end
 
 
 --[[
-@luaapi utils.get_call_depth(func, visited)
-@description Calculate the maximum call depth from a function (recursive calls)
+@luaapi utils.get_call_depth(func)
+@description Calculate the maximum call depth below a function, counting each recursion group (call-graph SCC) once
 @param func Function The function to analyze
-@param visited table Internal parameter for recursion tracking
 @return integer Maximum call depth from this function
 @example
 local depth = utils.get_call_depth(main_func)
 print(string.format("Max call depth from %s: %d", main_func.name, depth))
 ]]
-function utils.get_call_depth(func, visited)
-    visited = visited or {}
-    local func_addr = func.start_addr.value
-
-    -- Prevent infinite recursion
-    if visited[func_addr] then
-        return 0
-    end
-    visited[func_addr] = true
-
-    local max_depth = 0
-    for callee in func:each_call() do
-        local depth = utils.get_call_depth(callee, visited)
-        max_depth = math.max(max_depth, depth + 1)
-    end
-
-    visited[func_addr] = nil
-    return max_depth
+function utils.get_call_depth(func)
+    local graph = func.view:call_graph()
+    local index = graph:index_of(func)
+    return index and graph:call_depth(index) or 0
 end
 
 --[[
@@ -113,35 +158,15 @@ end
 ]]
 function utils.find_strings_in_function(func, pattern)
     local matching_strings = {}
-    local bv = func.view
-
-    -- Get all string references in the function
-    for block in func:each_basic_block() do
-        local start_addr = block.start_addr
-        local end_addr = block.end_addr
 
-        -- Iterate through instructions in the block
-        local addr = start_addr
-        while addr < end_addr do
-            local refs = bv:get_code_refs(addr)
-            if refs then
-                for _, ref in ipairs(refs) do
-                    local str = bv:get_string_at(ref)
-                    if str and str.value and str.value:match(pattern) then
-                        table.insert(matching_strings, {
-                            address = ref,
-                            string = str.value
-                        })
-                    end
-                end
-            end
-
-            local instr = bv:get_disassembly(addr)
-            if instr and instr.length then
-                addr = addr + instr.length
-            else
-                break
-            end
+    -- func:referenced_strings() answers from the native string xref
+    -- index, so there is no per-instruction walk through the bindings.
+    for _, str in ipairs(func:referenced_strings()) do
+        if str.value and str.value:match(pattern) then
+            table.insert(matching_strings, {
+                address = str.addr.value,
+                string = str.value
+            })
         end
     end
 
@@ -159,24 +184,13 @@ print(string.format("Function %s: %d blocks, cyclomatic complexity: %d",
     func.name, complexity.blocks, complexity.cyclomatic))
 ]]
 function utils.get_function_complexity(func)
-    local block_count = 0
-    local edge_count = 0
-
-    for block in func:each_basic_block() do
-        block_count = block_count + 1
-        local outgoing = block:outgoing_edges()
-        if outgoing then
-            edge_count = edge_count + #outgoing
-        end
-    end
-
-    -- Cyclomatic complexity: E - N + 2P (P=1 for single function)
-    local cyclomatic = edge_count - block_count + 2
-
+    -- Cyclomatic complexity: E - N + 2P (P=1 for single function),
+    -- from the cached native summary
+    local summary = func:summary()
     return {
-        blocks = block_count,
-        edges = edge_count,
-        cyclomatic = cyclomatic
+        blocks = summary.block_count,
+        edges = summary.edge_count,
+        cyclomatic = summary.cyclomatic_complexity
     }
 end
 
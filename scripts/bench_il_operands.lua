@@ -0,0 +1,66 @@
+-- Micro-benchmark for IL operand projection (instr:operands()).
+--
+-- Run from the Binary Ninja Lua console with a view open:
+--
+--     dofile("/path/to/binja-lua/scripts/bench_il_operands.lua")
+--
+-- Walks every LLIL / MLIL / HLIL expression tree of every function,
+-- projecting each node's operands, and reports operands/sec per IL
+-- level. IL is materialized while the roots are collected, so the
+-- timed passes measure projection rather than analysis. Operand tables
+-- are memoized until the next full GC cycle, so each round starts with
+-- collectgarbage() to time cold projection. Compare numbers
+-- from two builds on the same binary to evaluate a change to
+-- bindings/il_operand_conv.cpp.
+
+local ROUNDS = 3
+
+local function walk(instr, counter)
+    local ops = instr:operands()
+    counter.n = counter.n + #ops
+    for _, op in ipairs(ops) do
+        if type(op) == "userdata" and op.operation ~= nil then
+            walk(op, counter)
+        elseif type(op) == "table" then
+            for _, sub in ipairs(op) do
+                if type(sub) == "userdata" and sub.operation ~= nil then
+                    walk(sub, counter)
+                end
+            end
+        end
+    end
+end
+
+local function collect(level)
+    local roots = {}
+    for _, func in ipairs(bv:functions()) do
+        local il = func[level]
+        if il then
+            for i = 0, il.instruction_count - 1 do
+                roots[#roots + 1] = il:instruction_at(i)
+            end
+        end
+    end
+    return roots
+end
+
+for _, level in ipairs({"llil", "mlil", "hlil"}) do
+    local roots = collect(level)
+    local best = 0
+    local operands = 0
+    for _ = 1, ROUNDS do
+        local counter = {n = 0}
+        collectgarbage()
+        local t0 = os.clock()
+        for _, root in ipairs(roots) do
+            walk(root, counter)
+        end
+        local dt = os.clock() - t0
+        operands = counter.n
+        if dt > 0 then
+            best = math.max(best, counter.n / dt)
+        end
+    end
+    print(string.format("%-4s %8d roots %10d operands %12.0f operands/sec",
+                        level, #roots, operands, best))
+end
@@ -36,6 +36,15 @@ PY_LLIL = REPO_ROOT / "binaryninja-api" / "python" / "lowlevelil.py"
 PY_MLIL = REPO_ROOT / "binaryninja-api" / "python" / "mediumlevelil.py"
 PY_HLIL = REPO_ROOT / "binaryninja-api" / "python" / "highlevelil.py"
 ENUMS_OUT = REPO_ROOT / "bindings" / "il_enums.inc"
+TAGS_OUT = REPO_ROOT / "bindings" / "il_operand_tags.inc"
+PROJECTORS_OUT = REPO_ROOT / "bindings" / "il_operand_projectors.inc"
+
+# Per-family C++ instruction type, for the generated projectors.
+INSTRUCTION_TYPES: Dict[str, str] = {
+    "LLIL": "LowLevelILInstruction",
+    "MLIL": "MediumLevelILInstruction",
+    "HLIL": "HighLevelILInstruction",
+}
 OPERANDS_OUT = REPO_ROOT / "bindings" / "il_operands_table.inc"
 
 LLIL_OP_LINES = (586, 737)
@@ -102,6 +111,26 @@ ACCESSOR_TO_TAG: Dict[str, Tuple[str, int]] = {
     "_get_member_index":           ("member_index",           1),
 }
 
+# Tags with a projector branch in il_operand_conv.cpp but no accessor
+# in ACCESSOR_TO_TAG (carried over from the string-keyed dispatch), so
+# they still need an enumerator for the if-constexpr chain to compile.
+EXTRA_OPERAND_TAGS: List[str] = ["reg_stack_ssa_dest_and_src"]
+
+# Tag vocabulary in enumerator order: every ACCESSOR_TO_TAG tag (first
+# occurrence wins), the EXTRA_OPERAND_TAGS, plus the "unknown" tag the
+# extractor emits for fields it cannot resolve to an accessor.
+OPERAND_TAGS: List[str] = list(dict.fromkeys(
+    [tag for tag, _ in ACCESSOR_TO_TAG.values()] + EXTRA_OPERAND_TAGS
+    + ["unknown"]))
+
+
+def tag_enumerator(tag: str) -> str:
+    """C++ ILOperandTag enumerator for a type_tag string: snake_case
+    parts are capitalized ("reg_ssa" -> "RegSSA"); CamelCase tags such
+    as ConstantData pass through."""
+    return "".join("SSA" if part == "ssa" else part[:1].upper() + part[1:]
+                   for part in tag.split("_"))
+
 
 def extract_enumerators(path: Path, start: int, end: int,
                         prefix: str) -> List[str]:
@@ -212,18 +241,23 @@ OPERANDS_HEADER = """\
 //
 // Contents:
 //   - LLILOperandSpecsForOperation(BNLowLevelILOperation) returning
-//     the per-opcode const vector<LLILOperandSpec>& used by
-//     LLILOperandToLua to project raw instruction operands into Lua
-//     values. Originally landed in R9.1 commit 2a.
-//   - MLILOperandSpecsForOperation(BNMediumLevelILOperation) returning
-//     the per-opcode const vector<MLILOperandSpec>& used by
-//     MLILOperandToLua. Added in R9.2 commit B.
+//     a span over the per-opcode constexpr std::array of
+//     LLILOperandSpec used by LLILOperandToLua to project raw
+//     instruction operands into Lua values. Originally landed in R9.1
+//     commit 2a.
+//   - MLILOperandSpecsForOperation(BNMediumLevelILOperation) and
+//     HLILOperandSpecsForOperation(BNHighLevelILOperation), same shape.
+//     Added in R9.2 / R9.3 commit B.
 //
 // *OperandSpec shape (structs defined in bindings/il.h, field-identical
-// between the two families):
+// between the families):
 //     struct LLILOperandSpec { const char* name; const char* type_tag;
+//                              ILOperandTag tag;
 //                              uint8_t slot_first; uint8_t slot_last; };
 //     struct MLILOperandSpec { same; };
+// `tag` is the enum form of type_tag (bindings/il_operand_tags.inc)
+// that the projectors switch on; type_tag is kept for
+// detailed_operands output.
 //
 // For single-slot scalars and single-slot list/map accessors, slot_last
 // == slot_first. For explicit-pair accessors (reg_ssa, flag_ssa,
@@ -235,8 +269,8 @@ OPERANDS_HEADER = """\
 // Opcodes with empty detailed_operands (LLIL_NOP, LLIL_NORET, LLIL_POP,
 // LLIL_SYSCALL, LLIL_BP, LLIL_UNDEF, LLIL_UNIMPL, MLIL_NOP,
 // MLIL_NORET, MLIL_BP, MLIL_UNDEF, MLIL_UNIMPL, plus opcodes whose
-// Python subclass is not concretely defined) map to an empty spec
-// vector via each switch's default arm.
+// Python subclass is not concretely defined) map to an empty span via
+// each switch's default arm.
 //
 // This file is included by bindings/il_operand_conv.cpp inside the
 // BinjaLua namespace.
@@ -509,42 +543,151 @@ def emit_operands_table(operations: List[str],
     identical.
     """
     lines: List[str] = []
-    lines.append(f"static const std::vector<{family}OperandSpec> "
-                 f"k{family}OperandSpecsEmpty{{}};")
-    lines.append("")
-
-    non_empty: List[Tuple[str, List[Tuple[str, str, int, int]]]] = []
-    for op in operations:
-        specs = extractor.specs_for_op(op)
-        if specs:
-            non_empty.append((op, specs))
-
-    for op, specs in non_empty:
+    for op, specs in non_empty_specs(operations, extractor):
         lines.append(
-            f"static const std::vector<{family}OperandSpec> "
-            f"k{family}OperandSpecs_{op}{{"
+            f"static constexpr std::array<{family}OperandSpec, {len(specs)}> "
+            f"k{family}OperandSpecs_{op}{{{{"
         )
         for name, tag, sf, sl in specs:
             lines.append(
                 f"    {{\"{name}\", \"{tag}\", "
+                f"ILOperandTag::{tag_enumerator(tag)}, "
                 f"static_cast<uint8_t>({sf}), "
                 f"static_cast<uint8_t>({sl})}},"
             )
-        lines.append("};")
+        lines.append("}};")
         lines.append("")
 
-    lines.append(f"const std::vector<{family}OperandSpec>& "
+    lines.append(f"std::span<const {family}OperandSpec> "
                  f"{family}OperandSpecsForOperation({enum_type} op) {{")
     lines.append("    switch (op) {")
-    for op, _ in non_empty:
+    for op, _ in non_empty_specs(operations, extractor):
         lines.append(
             f"        case {op}: return k{family}OperandSpecs_{op};")
-    lines.append(f"        default: return k{family}OperandSpecsEmpty;")
+    lines.append("        default: return {};")
+    lines.append("    }")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def non_empty_specs(operations: List[str],
+                    extractor: DetailedOperandsExtractor
+                    ) -> List[Tuple[str, List[Tuple[str, str, int, int]]]]:
+    out: List[Tuple[str, List[Tuple[str, str, int, int]]]] = []
+    for op in operations:
+        specs = extractor.specs_for_op(op)
+        if specs:
+            out.append((op, specs))
+    return out
+
+
+def emit_projectors(operations: List[str],
+                    extractor: DetailedOperandsExtractor,
+                    family: str,
+                    enum_type: str) -> str:
+    """Emit one straight-line operand projector per opcode plus the
+    Project<family>Operands switch over them.
+
+    Each projector reads every slot through the tag-specialized
+    <family>OperandAs<Tag> template (hand-written in
+    bindings/il_operand_conv.cpp) and hands (index, spec, value) to a
+    caller-supplied sink, so `operands` and `detailed_operands` share
+    the same generated code without interpreting the spec table.
+    """
+    instr_type = INSTRUCTION_TYPES[family]
+    signature = (f"sol::state_view lua, const {instr_type}& instr, "
+                 f"const ArchNameTables& names, Sink& sink")
+    lines: List[str] = []
+    non_empty = non_empty_specs(operations, extractor)
+    for op, specs in non_empty:
+        lines.append("template <typename Sink>")
+        lines.append(f"void Project{family}Operands_{op}(")
+        lines.append(f"    {signature}) {{")
+        lines.append(f"    const auto& specs = k{family}OperandSpecs_{op};")
+        for i, (_, tag, _, _) in enumerate(specs):
+            lines.append(
+                f"    sink({i + 1}, specs[{i}], {family}OperandAs<"
+                f"ILOperandTag::{tag_enumerator(tag)}>(lua, instr, "
+                f"specs[{i}], names));")
+        lines.append("}")
+        lines.append("")
+
+    lines.append("template <typename Sink>")
+    lines.append(f"void Project{family}Operands(")
+    lines.append(f"    {signature}) {{")
+    lines.append("    switch (instr.operation) {")
+    for op, _ in non_empty:
+        lines.append(f"        case {op}:")
+        lines.append(f"            Project{family}Operands_{op}"
+                     f"(lua, instr, names, sink);")
+        lines.append("            return;")
+    lines.append("        default:")
+    lines.append("            return;")
     lines.append("    }")
     lines.append("}")
     return "\n".join(lines) + "\n"
 
 
+TAGS_HEADER = """\
+// Auto-generated from the ACCESSOR_TO_TAG table in
+// scripts/generate_il_tables.py.
+// Generator: scripts/generate_il_tables.py (tracked, run by hand).
+// Do NOT hand-edit.
+//
+// ILOperandTag is the integer form of the *OperandSpec::type_tag
+// strings, shared by the LLIL / MLIL / HLIL spec tables so the operand
+// projectors dispatch with a switch instead of string compares.
+//
+// This file is included by bindings/il.h inside the BinjaLua
+// namespace.
+"""
+
+
+PROJECTORS_HEADER = """\
+// Auto-generated from binaryninja-api/python/lowlevelil.py,
+// mediumlevelil.py and highlevelil.py.
+// Generator: scripts/generate_il_tables.py (tracked, run by hand).
+// Do NOT hand-edit. Regenerate after bumping the BN submodule.
+//
+// One projector per opcode with a non-empty spec table: each reads
+// its slots with the tag-specialized {LLIL,MLIL,HLIL}OperandAs<Tag>
+// templates and passes (1-based index, spec, value) to a sink, plus a
+// Project{LLIL,MLIL,HLIL}Operands switch that picks the projector for
+// instr.operation. Opcodes without operands fall through to a no-op.
+//
+// This file is included by bindings/il_operand_conv.cpp inside the
+// BinjaLua namespace, after the *OperandAs templates.
+"""
+
+
+def emit_operand_tags() -> int:
+    lines: List[str] = [TAGS_HEADER, "enum class ILOperandTag : uint8_t {"]
+    for tag in OPERAND_TAGS:
+        lines.append(f"    {tag_enumerator(tag)},  // \"{tag}\"")
+    lines.append("};")
+    lines.append("")
+    lines.append("// Calls f.template operator()<Tag>() with the runtime tag lifted to a")
+    lines.append("// template argument, so generic callers reach the same tag-specialized")
+    lines.append("// projector bodies the generated per-opcode projectors use.")
+    lines.append("template <typename F>")
+    lines.append("decltype(auto) VisitOperandTag(ILOperandTag tag, F&& f) {")
+    lines.append("    switch (tag) {")
+    for tag in OPERAND_TAGS:
+        e = tag_enumerator(tag)
+        if e == "Unknown":
+            continue
+        lines.append(f"    case ILOperandTag::{e}:")
+        lines.append(f"        return f.template operator()<ILOperandTag::{e}>();")
+    lines.append("    default:")
+    lines.append("        return f.template operator()<ILOperandTag::Unknown>();")
+    lines.append("    }")
+    lines.append("}")
+    output = "\n".join(lines) + "\n"
+    TAGS_OUT.write_text(output, encoding="utf-8", newline="\n")
+    print(f"wrote {TAGS_OUT} ({len(OPERAND_TAGS)} tags)")
+    return 0
+
+
 def emit_enums() -> Tuple[int, int]:
     if not BN_HEADER.exists():
         print(f"error: missing {BN_HEADER}", file=sys.stderr)
@@ -638,6 +781,21 @@ def emit_operands() -> int:
     output = "".join(parts)
     OPERANDS_OUT.write_text(output, encoding="utf-8", newline="\n")
 
+    projector_parts: List[str] = [PROJECTORS_HEADER, "\n"]
+    projector_parts.append("// ---- LLIL projectors ----\n\n")
+    projector_parts.append(emit_projectors(
+        llil_ops, llil_extractor, "LLIL", "BNLowLevelILOperation"))
+    projector_parts.append("\n")
+    projector_parts.append("// ---- MLIL projectors ----\n\n")
+    projector_parts.append(emit_projectors(
+        mlil_ops, mlil_extractor, "MLIL", "BNMediumLevelILOperation"))
+    projector_parts.append("\n")
+    projector_parts.append("// ---- HLIL projectors ----\n\n")
+    projector_parts.append(emit_projectors(
+        hlil_ops, hlil_extractor, "HLIL", "BNHighLevelILOperation"))
+    PROJECTORS_OUT.write_text("".join(projector_parts), encoding="utf-8",
+                              newline="\n")
+
     llil_covered = sum(
         1 for op in llil_ops if llil_extractor.specs_for_op(op))
     mlil_covered = sum(
@@ -677,6 +835,9 @@ def main() -> int:
     ops_n, _conds_n = emit_enums()
     if ops_n < 0:
         return 1
+    rc = emit_operand_tags()
+    if rc != 0:
+        return rc
     rc = emit_operands()
     if rc != 0:
         return rc